@@ -0,0 +1,165 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include "Vector3.hpp"
+
+template <typename T>
+struct AABB {
+    Vector3<T> min;
+    Vector3<T> max;
+
+    constexpr AABB()
+        : min(Infinity(), Infinity(), Infinity()), max(NegativeInfinity(), NegativeInfinity(), NegativeInfinity()) {
+    }
+
+    constexpr AABB(const Vector3<T>& min, const Vector3<T>& max) : min(min), max(max) {
+    }
+
+    static constexpr AABB fromPoint(const Vector3<T>& point) {
+        return AABB{point, point};
+    }
+
+    template <typename V>
+    static constexpr auto& axis(V& v, int a) {
+        return a == 0 ? v.x : a == 1 ? v.y : v.z;
+    }
+
+    constexpr bool empty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    constexpr Vector3<T> center() const {
+        return min + size() / 2;
+    }
+
+    constexpr Vector3<T> size() const {
+        return max - min;
+    }
+
+    constexpr auto surfaceArea() const {
+        auto d = size();
+        return (d.x * d.y + d.y * d.z + d.z * d.x) * 2;
+    }
+
+    constexpr int longestAxis() const {
+        auto d = size();
+        if (d.x >= d.y && d.x >= d.z) return 0;
+        return d.y >= d.z ? 1 : 2;
+    }
+
+    constexpr void expand(const Vector3<T>& point) {
+        min = Vector3<T>{std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z)};
+        max = Vector3<T>{std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z)};
+    }
+
+    constexpr void expand(const AABB& other) {
+        min = Vector3<T>{std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z)};
+        max = Vector3<T>{std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z)};
+    }
+
+    constexpr AABB merged(const AABB& other) const {
+        AABB result = *this;
+        result.expand(other);
+        return result;
+    }
+
+    constexpr bool contains(const Vector3<T>& point) const {
+        return point.x >= min.x && point.x <= max.x &&
+            point.y >= min.y && point.y <= max.y &&
+            point.z >= min.z && point.z <= max.z;
+    }
+
+    constexpr bool contains(const AABB& other) const {
+        return other.min.x >= min.x && other.max.x <= max.x &&
+            other.min.y >= min.y && other.max.y <= max.y &&
+            other.min.z >= min.z && other.max.z <= max.z;
+    }
+
+    constexpr bool intersects(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+            min.y <= other.max.y && max.y >= other.min.y &&
+            min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    constexpr bool operator==(const AABB&) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, const AABB& box) {
+        return os << "{min: " << box.min << ", max: " << box.max << "}";
+    }
+
+private:
+    // The largest value of T, so that an empty box starts as min = +Infinity, max = -Infinity. Only floating-point
+    // values have an infinity; integer and fixed-point ones use their maximum instead.
+    template <typename V>
+    static constexpr V Largest() {
+        if constexpr (std::numeric_limits<V>::has_infinity) return std::numeric_limits<V>::infinity();
+        else if constexpr (std::numeric_limits<V>::is_specialized) return std::numeric_limits<V>::max();
+        else if constexpr (requires { V::fromRaw(std::numeric_limits<typename V::rep>::max()); })
+            return V::fromRaw(std::numeric_limits<typename V::rep>::max());
+        else return V(std::numeric_limits<Unit::float_t>::infinity());
+    }
+
+    // The lowest value of T, taken directly rather than as -Largest(), which wraps to 1 for unsigned values.
+    template <typename V>
+    static constexpr V Lowest() {
+        if constexpr (std::numeric_limits<V>::has_infinity) return -std::numeric_limits<V>::infinity();
+        else if constexpr (std::numeric_limits<V>::is_specialized) return std::numeric_limits<V>::lowest();
+        else if constexpr (requires { V::fromRaw(std::numeric_limits<typename V::rep>::lowest()); })
+            return V::fromRaw(std::numeric_limits<typename V::rep>::lowest());
+        else return V(-std::numeric_limits<Unit::float_t>::infinity());
+    }
+
+    static constexpr T Infinity() {
+        if constexpr (Unit::is_quantity_v<T>) return T(Largest<typename T::value_type>());
+        else return Largest<T>();
+    }
+
+    static constexpr T NegativeInfinity() {
+        if constexpr (Unit::is_quantity_v<T>) return T(Lowest<typename T::value_type>());
+        else return Lowest<T>();
+    }
+};
+
+// A ray with an origin in T and a unit-less direction, so that hit distances are measured in T.
+template <typename T>
+struct Ray {
+    Vector3<T> origin;
+    Vector3<Unit::float_t> direction;
+
+    constexpr Ray(const Vector3<T>& origin, const Vector3<Unit::float_t>& direction)
+        : origin(origin), direction(direction) {
+    }
+
+    constexpr Vector3<T> at(T t) const {
+        return origin + Vector3<T>{t * direction.x, t * direction.y, t * direction.z};
+    }
+
+    // Slab test; returns the entry distance if the box is hit within [0, tMax].
+    constexpr std::optional<T> intersect(const AABB<T>& box, T tMax) const {
+        T tNear = T(0);
+        T tFar = tMax;
+        for (int a = 0; a < 3; ++a) {
+            auto inv = 1.0 / AABB<T>::axis(direction, a);
+            T t0 = (AABB<T>::axis(box.min, a) - AABB<T>::axis(origin, a)) * inv;
+            T t1 = (AABB<T>::axis(box.max, a) - AABB<T>::axis(origin, a)) * inv;
+            if (t0 > t1) std::swap(t0, t1);
+            tNear = t0 > tNear ? t0 : tNear;
+            tFar = t1 < tFar ? t1 : tFar;
+        }
+        if (tNear > tFar) return std::nullopt;
+        return tNear;
+    }
+};
@@ -0,0 +1,205 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// libstdc++ implements the std execution policies on top of TBB, which then has to be linked even if only
+// <execution> is included, so accepting them is opt-in.
+#ifdef UNIT_HPP_STD_EXECUTION
+#include <execution>
+#endif
+
+#include "Executor.hpp"
+#include "Reduce.hpp"
+#include "Unit.hpp"
+
+// Parallel algorithms over contiguous ranges of quantities. The element types of the results follow the units of
+// the inputs and are converted, with the usual dimension check, to the element type of the output range, e.g. an
+// inclusive scan of m/s * s increments can be written straight into a range of m.
+namespace Unit {
+    // Runs on the calling thread.
+    struct SequencedPolicy {
+    };
+
+    // Runs on default_pool() with up to `threads` threads (0: all of them): Unit::par, or Unit::par(8).
+    struct ParallelPolicy {
+        size_t threads = 0;
+
+        constexpr ParallelPolicy operator()(size_t threadCount) const {
+            return ParallelPolicy{threadCount};
+        }
+    };
+
+    inline constexpr SequencedPolicy seq{};
+    inline constexpr ParallelPolicy par{};
+
+    template <typename P>
+    inline constexpr bool is_std_policy_v = false;
+#ifdef UNIT_HPP_STD_EXECUTION
+    template <typename P> requires std::is_execution_policy_v<P>
+    inline constexpr bool is_std_policy_v<P> = true;
+#endif
+
+    template <typename P>
+    concept execution_policy = std::is_same_v<std::remove_cvref_t<P>, SequencedPolicy> ||
+        std::is_same_v<std::remove_cvref_t<P>, ParallelPolicy> || is_std_policy_v<std::remove_cvref_t<P>>;
+
+    template <typename P>
+    constexpr size_t policy_threads(const P& policy) {
+        if constexpr (std::is_same_v<P, ParallelPolicy>) return policy.threads;
+        else return 1;
+    }
+
+    // out[i] = f(in[i]).
+    template <execution_policy P, std::ranges::contiguous_range In, std::ranges::contiguous_range Out, typename F>
+    void transform(P&& policy, const In& in, Out&& out, F f) {
+        using OutT = std::ranges::range_value_t<Out>;
+        const auto* src = std::ranges::data(in);
+        OutT* dst = std::ranges::data(out);
+        const size_t n = std::ranges::size(in);
+        if constexpr (is_std_policy_v<std::remove_cvref_t<P>>) {
+            std::transform(policy, src, src + n, dst, [&](const auto& x) { return OutT(f(x)); });
+        } else {
+            parallel_for(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) dst[i] = OutT(f(src[i]));
+            }, policy_threads(policy));
+        }
+    }
+
+    // out[i] = f(a[i], b[i]); b holds at least as many elements as a.
+    template <execution_policy P, std::ranges::contiguous_range A, std::ranges::contiguous_range B,
+              std::ranges::contiguous_range Out, typename F>
+    void transform(P&& policy, const A& a, const B& b, Out&& out, F f) {
+        using OutT = std::ranges::range_value_t<Out>;
+        const auto* as = std::ranges::data(a);
+        const auto* bs = std::ranges::data(b);
+        OutT* dst = std::ranges::data(out);
+        const size_t n = std::ranges::size(a);
+        if constexpr (is_std_policy_v<std::remove_cvref_t<P>>) {
+            std::transform(policy, as, as + n, bs, dst, [&](const auto& x, const auto& y) { return OutT(f(x, y)); });
+        } else {
+            parallel_for(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) dst[i] = OutT(f(as[i], bs[i]));
+            }, policy_threads(policy));
+        }
+    }
+
+    // The results of f in a new vector of whatever f returns, e.g. a range of N mapped by [](N f) { return f * d; }
+    // gives a std::vector of N*m.
+    template <execution_policy P, std::ranges::contiguous_range In, typename F>
+    auto transform(P&& policy, const In& in, F f) {
+        std::vector<std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<const In>>>> out(
+            std::ranges::size(in));
+        transform(std::forward<P>(policy), in, out, std::move(f));
+        return out;
+    }
+
+    // Calls f on every element, possibly concurrently.
+    template <execution_policy P, std::ranges::contiguous_range R, typename F>
+    void for_each(P&& policy, R&& range, F f) {
+        auto* data = std::ranges::data(range);
+        const size_t n = std::ranges::size(range);
+        if constexpr (is_std_policy_v<std::remove_cvref_t<P>>) {
+            std::for_each(policy, data, data + n, f);
+        } else {
+            parallel_for(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) f(data[i]);
+            }, policy_threads(policy));
+        }
+    }
+
+    // out[i] = in[0] + ... + in[i], accumulated in the unit of the input and converted to the element type of out.
+    // In parallel, the chunk sums are computed first and every chunk is then scanned from its offset, so floating
+    // point results may differ from the serial scan by rounding.
+    template <execution_policy P, std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+        requires is_quantity_v<std::ranges::range_value_t<In>>
+    void inclusive_scan(P&& policy, const In& in, Out&& out) {
+        using Q = std::ranges::range_value_t<In>;
+        using S = decltype(std::declval<Q>() + std::declval<Q>());
+        using OutT = std::ranges::range_value_t<Out>;
+        const Q* src = std::ranges::data(in);
+        OutT* dst = std::ranges::data(out);
+        const size_t n = std::ranges::size(in);
+        const auto scan = [&](size_t begin, size_t end, S acc) {
+            for (size_t i = begin; i < end; ++i) {
+                acc = acc + src[i];
+                dst[i] = OutT(acc);
+            }
+        };
+        if constexpr (is_std_policy_v<std::remove_cvref_t<P>>) {
+            std::vector<S> sums(n);
+            std::inclusive_scan(policy, src, src + n, sums.data(), std::plus<>{}, S{});
+            std::transform(policy, sums.data(), sums.data() + n, dst, [](const S& s) { return OutT(s); });
+        } else {
+            const size_t threads = policy_threads(policy);
+            if (threads == 1 || n < 2 * default_pool().grain()) {
+                scan(0, n, S{});
+                return;
+            }
+            auto offsets = parallel_chunks(n, threads, [&](size_t begin, size_t end) {
+                S acc{};
+                for (size_t i = begin; i < end; ++i) acc = acc + src[i];
+                return acc;
+            });
+            const size_t chunks = offsets.size();
+            S running{};
+            for (auto& offset : offsets) running = running + std::exchange(offset, running);
+            parallel_for(chunks, [&](size_t first, size_t last) {
+                for (size_t c = first; c < last; ++c) scan(n * c / chunks, n * (c + 1) / chunks, offsets[c]);
+            }, threads, 1);
+        }
+    }
+
+    template <execution_policy P, std::ranges::contiguous_range In>
+        requires is_quantity_v<std::ranges::range_value_t<In>>
+    auto inclusive_scan(P&& policy, const In& in) {
+        using Q = std::ranges::range_value_t<In>;
+        std::vector<decltype(std::declval<Q>() + std::declval<Q>())> out(std::ranges::size(in));
+        inclusive_scan(std::forward<P>(policy), in, out);
+        return out;
+    }
+
+    // Sorts in place. In parallel, the chunks are sorted concurrently and then merged pairwise.
+    template <execution_policy P, std::ranges::contiguous_range R, typename Compare = std::less<>>
+    void sort(P&& policy, R&& range, Compare comp = {}) {
+        auto* data = std::ranges::data(range);
+        const size_t n = std::ranges::size(range);
+        if constexpr (is_std_policy_v<std::remove_cvref_t<P>>) {
+            std::sort(policy, data, data + n, comp);
+        } else {
+            const size_t threads = policy_threads(policy);
+            if (threads == 1 || n < 2 * default_pool().grain()) {
+                std::sort(data, data + n, comp);
+                return;
+            }
+            const size_t chunks = n / default_pool().grain();
+            const auto bound = [&](size_t c) { return data + n * std::min(c, chunks) / chunks; };
+            parallel_for(chunks, [&](size_t first, size_t last) {
+                for (size_t c = first; c < last; ++c) std::sort(bound(c), bound(c + 1), comp);
+            }, threads, 1);
+            for (size_t width = 1; width < chunks; width *= 2) {
+                parallel_for((chunks + 2 * width - 1) / (2 * width), [&](size_t first, size_t last) {
+                    for (size_t pair = first; pair < last; ++pair) {
+                        const size_t c = pair * 2 * width;
+                        std::inplace_merge(bound(c), bound(c + width), bound(c + 2 * width), comp);
+                    }
+                }, threads, 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,181 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // std::atomic over the raw value of Quantity<U, V>. Quantities of other units of the same dimension are
+    // converted to U before they are added, subtracted or stored. Arithmetic needs an integer or floating-point V,
+    // for which it is lock-free on common targets (floating-point fetch_add is a CAS loop in hardware or libatomic).
+    template <typename U, typename V = float_t>
+    struct AtomicQuantity {
+        using quantity_type = Quantity<U, V>;
+        using value_type = V;
+
+        static constexpr bool is_always_lock_free = std::atomic<V>::is_always_lock_free;
+
+        constexpr AtomicQuantity() noexcept : value(V(0)) {
+        }
+
+        constexpr explicit AtomicQuantity(const quantity_type& q) noexcept : value(q.value) {
+        }
+
+        AtomicQuantity(const AtomicQuantity&) = delete;
+        AtomicQuantity& operator=(const AtomicQuantity&) = delete;
+
+        bool is_lock_free() const noexcept {
+            return value.is_lock_free();
+        }
+
+        quantity_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+            return quantity_type(value.load(order));
+        }
+
+        void store(const quantity_type& q, std::memory_order order = std::memory_order_seq_cst) noexcept {
+            value.store(q.value, order);
+        }
+
+        quantity_type exchange(const quantity_type& q, std::memory_order order = std::memory_order_seq_cst) noexcept {
+            return quantity_type(value.exchange(q.value, order));
+        }
+
+        // On failure `expected` receives the current value, as with std::atomic.
+        bool compare_exchange_weak(quantity_type& expected, const quantity_type& desired,
+                                   std::memory_order order = std::memory_order_seq_cst) noexcept {
+            return value.compare_exchange_weak(expected.value, desired.value, order);
+        }
+
+        bool compare_exchange_strong(quantity_type& expected, const quantity_type& desired,
+                                     std::memory_order order = std::memory_order_seq_cst) noexcept {
+            return value.compare_exchange_strong(expected.value, desired.value, order);
+        }
+
+        // Adds q and returns the previous value.
+        template <typename OU, typename OV> requires std::is_arithmetic_v<V>
+        quantity_type fetch_add(const Quantity<OU, OV>& q, std::memory_order order = std::memory_order_seq_cst) {
+            return quantity_type(value.fetch_add(quantity_type{q}.value, order));
+        }
+
+        template <typename OU, typename OV> requires std::is_arithmetic_v<V>
+        quantity_type fetch_sub(const Quantity<OU, OV>& q, std::memory_order order = std::memory_order_seq_cst) {
+            return quantity_type(value.fetch_sub(quantity_type{q}.value, order));
+        }
+
+        // Applies f to the current value until the CAS succeeds and returns the previous value, for updates that
+        // std::atomic has no instruction for, such as a running maximum.
+        template <typename F>
+        quantity_type fetch_update(F f, std::memory_order order = std::memory_order_seq_cst) {
+            V current = value.load(std::memory_order_relaxed);
+            while (!value.compare_exchange_weak(current, quantity_type{f(quantity_type(current))}.value, order)) {
+            }
+            return quantity_type(current);
+        }
+
+        template <typename OU, typename OV> requires std::is_arithmetic_v<V>
+        quantity_type operator+=(const Quantity<OU, OV>& q) {
+            const V delta = quantity_type{q}.value;
+            return quantity_type(static_cast<V>(value.fetch_add(delta) + delta));
+        }
+
+        template <typename OU, typename OV> requires std::is_arithmetic_v<V>
+        quantity_type operator-=(const Quantity<OU, OV>& q) {
+            const V delta = quantity_type{q}.value;
+            return quantity_type(static_cast<V>(value.fetch_sub(delta) - delta));
+        }
+
+        operator quantity_type() const noexcept {
+            return load();
+        }
+
+    private:
+        std::atomic<V> value;
+    };
+
+    template <typename Q>
+    using atomic_quantity_t = AtomicQuantity<typename Q::u, typename Q::value_type>;
+
+    // Counter for totals updated from many threads, such as energy or bytes transferred. Each thread adds into the
+    // shard its id hashes to, with relaxed atomics on separate cache lines, so updates stay uncontended as long as
+    // there are at least as many shards as threads; the shards are only summed when reading.
+    template <typename U, typename V = float_t>
+    struct ShardedQuantity {
+        static_assert(std::is_arithmetic_v<V>, "ShardedQuantity requires an integer or floating-point value type.");
+        using quantity_type = Quantity<U, V>;
+        using value_type = V;
+
+        explicit ShardedQuantity(size_t shardCount = std::thread::hardware_concurrency())
+            : count(std::max<size_t>(shardCount, 1)), shards(new Shard[count]) {
+        }
+
+        template <typename OU, typename OV>
+        void add(const Quantity<OU, OV>& q) {
+            shard().value.fetch_add(quantity_type{q}.value, std::memory_order_relaxed);
+        }
+
+        template <typename OU, typename OV>
+        void sub(const Quantity<OU, OV>& q) {
+            shard().value.fetch_sub(quantity_type{q}.value, std::memory_order_relaxed);
+        }
+
+        template <typename OU, typename OV>
+        ShardedQuantity& operator+=(const Quantity<OU, OV>& q) {
+            add(q);
+            return *this;
+        }
+
+        template <typename OU, typename OV>
+        ShardedQuantity& operator-=(const Quantity<OU, OV>& q) {
+            sub(q);
+            return *this;
+        }
+
+        // Sum of the shards. Updates may continue meanwhile; the result then includes some of them.
+        quantity_type load() const {
+            V total = V(0);
+            for (size_t i = 0; i < count; ++i) total += shards[i].value.load(std::memory_order_relaxed);
+            return quantity_type(total);
+        }
+
+        // Returns the total and resets it to zero; updates racing with it land in either the result or the new total.
+        quantity_type reset() {
+            V total = V(0);
+            for (size_t i = 0; i < count; ++i) total += shards[i].value.exchange(V(0), std::memory_order_relaxed);
+            return quantity_type(total);
+        }
+
+        operator quantity_type() const {
+            return load();
+        }
+
+    private:
+        struct alignas(64) Shard {
+            std::atomic<V> value{V(0)};
+        };
+
+        size_t count;
+        std::unique_ptr<Shard[]> shards;
+
+        Shard& shard() {
+            return shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % count];
+        }
+    };
+
+    template <typename Q>
+    using sharded_quantity_t = ShardedQuantity<typename Q::u, typename Q::value_type>;
+}
@@ -0,0 +1,320 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "AABB.hpp"
+#include "Executor.hpp"
+
+// Bounding volume hierarchy over AABB<T>, built with binned SAH. Nodes are stored depth-first in a single
+// array: the left child of an interior node directly follows it, the right child is at `offset`.
+template <typename T>
+struct BVH {
+    struct Node {
+        AABB<T> bounds;
+        uint32_t offset; // first index into `indices` for leaves, right child for interior nodes
+        uint16_t count; // 0 for interior nodes
+        uint16_t axis;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> indices;
+    std::vector<AABB<T>> primitives; // primitive boxes in `indices` order, so leaves are scanned linearly
+
+    size_t maxLeafSize = 4;
+
+    BVH() = default;
+
+    explicit BVH(std::span<const AABB<T>> boxes, size_t threads = std::thread::hardware_concurrency()) {
+        build(boxes, threads);
+    }
+
+    void build(std::span<const AABB<T>> boxes, size_t threads = std::thread::hardware_concurrency()) {
+        nodes.clear();
+        indices.resize(boxes.size());
+        centroids.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            indices[i] = static_cast<uint32_t>(i);
+            centroids[i] = boxes[i].center();
+        }
+        if (boxes.empty()) return;
+
+        int spawnDepth = 0;
+        while ((size_t{1} << spawnDepth) < threads) ++spawnDepth;
+
+        nodes.reserve(2 * boxes.size() / maxLeafSize + 1);
+        if (spawnDepth == 0 || boxes.size() < ParallelThreshold) {
+            buildRange(boxes, nodes, 0, static_cast<uint32_t>(boxes.size()), 0, 0, nullptr);
+        } else {
+            // The top levels are split here, leaving up to 2^spawnDepth subtrees that are built as one pool job
+            // (pool jobs do not nest, so the subtrees cannot fork further) and then spliced in depth-first order.
+            std::vector<Node> top;
+            std::vector<Subtree> subtrees;
+            buildRange(boxes, top, 0, static_cast<uint32_t>(boxes.size()), 0, spawnDepth, &subtrees);
+            Unit::default_pool().parallelFor(subtrees.size(), [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    auto& subtree = subtrees[i];
+                    buildRange(boxes, subtree.nodes, subtree.begin, subtree.end, subtree.depth, 0, nullptr);
+                }
+            }, threads, 1);
+            splice(top, 0, subtrees);
+        }
+        centroids.clear();
+        centroids.shrink_to_fit();
+
+        primitives.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) primitives[i] = boxes[indices[i]];
+    }
+
+    // Recomputes node bounds after the boxes moved, keeping the topology. Children are always stored
+    // after their parent, so a single reverse sweep is enough.
+    void refit(std::span<const AABB<T>> boxes) {
+        for (size_t i = nodes.size(); i-- > 0;) {
+            auto& node = nodes[i];
+            if (node.count > 0) {
+                AABB<T> bounds;
+                for (uint32_t k = node.offset; k < node.offset + node.count; ++k) {
+                    primitives[k] = boxes[indices[k]];
+                    bounds.expand(primitives[k]);
+                }
+                node.bounds = bounds;
+            } else {
+                node.bounds = nodes[i + 1].bounds.merged(nodes[node.offset].bounds);
+            }
+        }
+    }
+
+    const AABB<T>& bounds() const {
+        return nodes[0].bounds;
+    }
+
+    template <typename F>
+    void queryOverlap(const AABB<T>& box, F&& f) const {
+        if (nodes.empty()) return;
+        uint32_t stack[MaxDepth * 2];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const auto& node = nodes[stack[--top]];
+            if (!node.bounds.intersects(box)) continue;
+            if (node.count > 0) {
+                for (uint32_t k = node.offset; k < node.offset + node.count; ++k) {
+                    if (primitives[k].intersects(box)) f(indices[k]);
+                }
+            } else {
+                stack[top++] = node.offset;
+                stack[top++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+            }
+        }
+    }
+
+    std::vector<uint32_t> queryOverlap(const AABB<T>& box) const {
+        std::vector<uint32_t> result;
+        queryOverlap(box, [&](uint32_t index) { result.push_back(index); });
+        return result;
+    }
+
+    // Calls f(index, tNear) for every box the ray enters within [0, tMax], nearest subtrees first.
+    template <typename F>
+    void queryRay(const Ray<T>& ray, T tMax, F&& f) const {
+        traverse(ray, tMax, [&](uint32_t index, T tNear, T&) { f(index, tNear); });
+    }
+
+    // Finds the closest primitive hit. `hit(index, ray, tMax)` returns the primitive's hit distance as an
+    // std::optional<T>; boxes beyond the closest hit found so far are skipped.
+    template <typename F>
+    std::optional<std::pair<uint32_t, T>> closestHit(const Ray<T>& ray, T tMax, F&& hit) const {
+        std::optional<std::pair<uint32_t, T>> best;
+        traverse(ray, tMax, [&](uint32_t index, T, T& limit) {
+            std::optional<T> t = hit(index, ray, limit);
+            if (t && *t <= limit) {
+                limit = *t;
+                best = std::pair<uint32_t, T>{index, *t};
+            }
+        });
+        return best;
+    }
+
+private:
+    static constexpr int Bins = 16;
+    static constexpr size_t ParallelThreshold = 4096;
+    static constexpr int MaxDepth = 64;
+
+    // Marks the placeholder of a deferred subtree in the top levels of a parallel build; offset is its index.
+    static constexpr uint16_t DeferredAxis = UINT16_MAX;
+
+    struct Subtree {
+        uint32_t begin;
+        uint32_t end;
+        int depth;
+        std::vector<Node> nodes;
+    };
+
+    std::vector<Vector3<T>> centroids;
+
+    template <typename F>
+    void traverse(const Ray<T>& ray, T tMax, F&& f) const {
+        if (nodes.empty()) return;
+        uint32_t stack[MaxDepth * 2];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const auto& node = nodes[stack[--top]];
+            if (!ray.intersect(node.bounds, tMax)) continue;
+            if (node.count > 0) {
+                for (uint32_t k = node.offset; k < node.offset + node.count; ++k) {
+                    if (auto tNear = ray.intersect(primitives[k], tMax)) f(indices[k], *tNear, tMax);
+                }
+            } else {
+                uint32_t left = static_cast<uint32_t>(&node - nodes.data()) + 1;
+                uint32_t right = node.offset;
+                // Push the far child first so that the near one is visited next.
+                if (AABB<T>::axis(ray.direction, node.axis) < 0) std::swap(left, right);
+                stack[top++] = right;
+                stack[top++] = left;
+            }
+        }
+    }
+
+    static double ratio(const auto& a, const auto& b) {
+        return static_cast<double>(a / b);
+    }
+
+    // With `deferred`, ranges reached after spawnDepth splits are only recorded there and left as placeholders.
+    void buildRange(std::span<const AABB<T>> boxes, std::vector<Node>& out, uint32_t begin, uint32_t end,
+                    int depth, int spawnDepth, std::vector<Subtree>* deferred) {
+        if (deferred && spawnDepth == 0) {
+            out.push_back(Node{AABB<T>{}, static_cast<uint32_t>(deferred->size()), 0, DeferredAxis});
+            deferred->push_back(Subtree{begin, end, depth, {}});
+            return;
+        }
+
+        AABB<T> bounds;
+        AABB<T> centroidBounds;
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds.expand(boxes[indices[i]]);
+            centroidBounds.expand(centroids[indices[i]]);
+        }
+
+        size_t self = out.size();
+        out.push_back(Node{bounds, begin, static_cast<uint16_t>(end - begin), 0});
+        uint32_t count = end - begin;
+        if (count <= maxLeafSize) return;
+
+        int axis = centroidBounds.longestAxis();
+        T cmin = AABB<T>::axis(centroidBounds.min, axis);
+        T cmax = AABB<T>::axis(centroidBounds.max, axis);
+        uint32_t mid = begin + count / 2;
+
+        if (cmax > cmin && depth >= MaxDepth / 2) {
+            // Deep subtrees fall back to median splits so that the traversal stacks stay bounded.
+            std::nth_element(
+                indices.begin() + begin, indices.begin() + mid, indices.begin() + end,
+                [&](uint32_t a, uint32_t b) {
+                    return AABB<T>::axis(centroids[a], axis) < AABB<T>::axis(centroids[b], axis);
+                }
+            );
+        } else if (cmax > cmin) {
+            struct Bin {
+                AABB<T> bounds;
+                uint32_t count = 0;
+            };
+            Bin bins[Bins];
+            auto binOf = [&](uint32_t index) {
+                auto b = static_cast<int>(Bins * ratio(AABB<T>::axis(centroids[index], axis) - cmin, cmax - cmin));
+                return std::min(b, Bins - 1);
+            };
+            for (uint32_t i = begin; i < end; ++i) {
+                auto& bin = bins[binOf(indices[i])];
+                bin.bounds.expand(boxes[indices[i]]);
+                ++bin.count;
+            }
+
+            // Sweep from the right to get suffix areas, then from the left to evaluate every split plane.
+            double rightArea[Bins];
+            uint32_t rightCount[Bins];
+            AABB<T> acc;
+            uint32_t n = 0;
+            for (int b = Bins - 1; b > 0; --b) {
+                acc.expand(bins[b].bounds);
+                n += bins[b].count;
+                rightArea[b] = n > 0 ? ratio(acc.surfaceArea(), bounds.surfaceArea()) : 0.0;
+                rightCount[b] = n;
+            }
+
+            double bestCost = static_cast<double>(count);
+            int bestSplit = -1;
+            acc = AABB<T>{};
+            n = 0;
+            for (int b = 0; b < Bins - 1; ++b) {
+                acc.expand(bins[b].bounds);
+                n += bins[b].count;
+                if (n == 0 || rightCount[b + 1] == 0) continue;
+                double cost = 1.0 + ratio(acc.surfaceArea(), bounds.surfaceArea()) * n +
+                    rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = b;
+                }
+            }
+
+            if (bestSplit < 0) {
+                if (count <= UINT16_MAX) return;
+            } else {
+                mid = static_cast<uint32_t>(std::partition(
+                    indices.begin() + begin, indices.begin() + end,
+                    [&](uint32_t index) { return binOf(index) <= bestSplit; }
+                ) - indices.begin());
+            }
+        } else if (count <= UINT16_MAX) {
+            return;
+        }
+
+        out[self].count = 0;
+        out[self].axis = static_cast<uint16_t>(axis);
+
+        if (!deferred || count < ParallelThreshold) {
+            spawnDepth = 0;
+            deferred = nullptr;
+        } else {
+            --spawnDepth;
+        }
+        buildRange(boxes, out, begin, mid, depth + 1, spawnDepth, deferred);
+        out[self].offset = static_cast<uint32_t>(out.size());
+        buildRange(boxes, out, mid, end, depth + 1, spawnDepth, deferred);
+    }
+
+    // Appends node i of `top` and its children to `nodes`, replacing placeholders by their subtrees.
+    void splice(const std::vector<Node>& top, uint32_t i, std::vector<Subtree>& subtrees) {
+        const Node& node = top[i];
+        if (node.axis == DeferredAxis) {
+            auto base = static_cast<uint32_t>(nodes.size());
+            for (Node child : subtrees[node.offset].nodes) {
+                if (child.count == 0) child.offset += base;
+                nodes.push_back(child);
+            }
+            return;
+        }
+        size_t self = nodes.size();
+        nodes.push_back(node);
+        if (node.count > 0) return;
+        splice(top, i + 1, subtrees);
+        nodes[self].offset = static_cast<uint32_t>(nodes.size());
+        splice(top, node.offset, subtrees);
+    }
+};
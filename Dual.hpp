@@ -0,0 +1,304 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <array>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // Dual number for forward-mode automatic differentiation: a value x together with its partial derivatives dx
+    // with respect to N independent variables. Used as a Quantity value type every operation, math function,
+    // Vector and Matrix operation also propagates the derivatives. The derivative lanes are updated in plain loops
+    // over a fixed-size array, which the compiler vectorizes.
+    //
+    // Comparisons only look at x. There is no conversion back to T, so derivatives are never dropped silently.
+    template <typename T, size_t N>
+    struct Dual {
+        static_assert(std::is_floating_point_v<T>, "Dual requires a floating-point T.");
+
+        using scalar_type = T;
+        static constexpr size_t size = N;
+
+        T x;
+        std::array<T, N> dx;
+
+        constexpr Dual() : x(0), dx{} {
+        }
+
+        // Constants have no derivatives.
+        template <typename V> requires std::is_arithmetic_v<V>
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr Dual(V v) : x(static_cast<T>(v)), dx{} {
+        }
+
+        constexpr Dual(T x, const std::array<T, N>& dx) : x(x), dx(dx) {
+        }
+
+        template <typename U>
+        constexpr explicit Dual(const Dual<U, N>& other) : x(static_cast<T>(other.x)), dx{} {
+            for (size_t i = 0; i < N; ++i) dx[i] = static_cast<T>(other.dx[i]);
+        }
+
+        // The independent variable `index`, i.e. x with a derivative of 1 in that lane.
+        static constexpr Dual variable(T x, size_t index) {
+            Dual d(x);
+            d.dx[index] = 1;
+            return d;
+        }
+
+        // f(x) for a function f with f'(x) = slope.
+        constexpr Dual chain(T fx, T slope) const {
+            Dual r(fx);
+            for (size_t i = 0; i < N; ++i) r.dx[i] = slope * dx[i];
+            return r;
+        }
+
+        // a * this + b * other for the derivatives of f(this, other) with partial derivatives a and b.
+        constexpr Dual chain(T fx, T a, const Dual& other, T b) const {
+            Dual r(fx);
+            for (size_t i = 0; i < N; ++i) r.dx[i] = a * dx[i] + b * other.dx[i];
+            return r;
+        }
+
+        constexpr Dual operator+(const Dual& rhs) const {
+            return chain(x + rhs.x, 1, rhs, 1);
+        }
+
+        constexpr Dual operator-(const Dual& rhs) const {
+            return chain(x - rhs.x, 1, rhs, -1);
+        }
+
+        constexpr Dual operator*(const Dual& rhs) const {
+            return chain(x * rhs.x, rhs.x, rhs, x);
+        }
+
+        constexpr Dual operator/(const Dual& rhs) const {
+            const T inv = 1 / rhs.x;
+            const T q = x * inv;
+            return chain(q, inv, rhs, -q * inv);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator+(const Dual& a, S b) {
+            Dual r = a;
+            r.x += static_cast<T>(b);
+            return r;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator+(S a, const Dual& b) {
+            return b + a;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator-(const Dual& a, S b) {
+            Dual r = a;
+            r.x -= static_cast<T>(b);
+            return r;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator-(S a, const Dual& b) {
+            return b.chain(static_cast<T>(a) - b.x, -1);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator*(const Dual& a, S b) {
+            return a.chain(a.x * static_cast<T>(b), static_cast<T>(b));
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator*(S a, const Dual& b) {
+            return b * a;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator/(const Dual& a, S b) {
+            const T inv = 1 / static_cast<T>(b);
+            return a.chain(a.x * inv, inv);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Dual operator/(S a, const Dual& b) {
+            const T q = static_cast<T>(a) / b.x;
+            return b.chain(q, -q / b.x);
+        }
+
+        constexpr Dual operator+() const {
+            return *this;
+        }
+
+        constexpr Dual operator-() const {
+            return chain(-x, -1);
+        }
+
+        constexpr Dual& operator+=(const Dual& rhs) {
+            return *this = *this + rhs;
+        }
+
+        constexpr Dual& operator-=(const Dual& rhs) {
+            return *this = *this - rhs;
+        }
+
+        constexpr Dual& operator*=(const Dual& rhs) {
+            return *this = *this * rhs;
+        }
+
+        constexpr Dual& operator/=(const Dual& rhs) {
+            return *this = *this / rhs;
+        }
+
+        constexpr bool operator==(const Dual& rhs) const {
+            return x == rhs.x;
+        }
+
+        constexpr std::partial_ordering operator<=>(const Dual& rhs) const {
+            return x <=> rhs.x;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        constexpr bool operator==(S rhs) const {
+            return x == static_cast<T>(rhs);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        constexpr std::partial_ordering operator<=>(S rhs) const {
+            return x <=> static_cast<T>(rhs);
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const Dual& d) {
+            os << d.x << " [";
+            for (size_t i = 0; i < N; ++i) os << (i ? ", " : "") << d.dx[i];
+            return os << "]";
+        }
+
+        friend Dual abs(const Dual& d) {
+            return d.x < 0 ? -d : d;
+        }
+
+        friend Dual floor(const Dual& d) {
+            return Dual(std::floor(d.x));
+        }
+
+        friend Dual ceil(const Dual& d) {
+            return Dual(std::ceil(d.x));
+        }
+
+        friend Dual fmod(const Dual& a, const Dual& b) {
+            return a.chain(std::fmod(a.x, b.x), 1, b, -std::trunc(a.x / b.x));
+        }
+
+        friend Dual sqrt(const Dual& d) {
+            const T r = std::sqrt(d.x);
+            return d.chain(r, 1 / (2 * r));
+        }
+
+        friend Dual cbrt(const Dual& d) {
+            const T r = std::cbrt(d.x);
+            return d.chain(r, 1 / (3 * r * r));
+        }
+
+        friend Dual pow(const Dual& d, T p) {
+            const T r = std::pow(d.x, p);
+            return d.chain(r, p * std::pow(d.x, p - 1));
+        }
+
+        friend Dual pow(const Dual& a, const Dual& b) {
+            const T r = std::pow(a.x, b.x);
+            return a.chain(r, b.x * std::pow(a.x, b.x - 1), b, a.x > 0 ? r * std::log(a.x) : T(0));
+        }
+
+        friend Dual exp(const Dual& d) {
+            const T r = std::exp(d.x);
+            return d.chain(r, r);
+        }
+
+        friend Dual log(const Dual& d) {
+            return d.chain(std::log(d.x), 1 / d.x);
+        }
+
+        friend Dual hypot(const Dual& a, const Dual& b) {
+            const T r = std::hypot(a.x, b.x);
+            return a.chain(r, a.x / r, b, b.x / r);
+        }
+
+        friend Dual hypot(const Dual& a, const Dual& b, const Dual& c) {
+            const T r = std::hypot(a.x, b.x, c.x);
+            Dual result = a.chain(r, a.x / r, b, b.x / r);
+            for (size_t i = 0; i < N; ++i) result.dx[i] += c.x / r * c.dx[i];
+            return result;
+        }
+
+        friend Dual sin(const Dual& d) {
+            return d.chain(std::sin(d.x), std::cos(d.x));
+        }
+
+        friend Dual cos(const Dual& d) {
+            return d.chain(std::cos(d.x), -std::sin(d.x));
+        }
+
+        friend Dual tan(const Dual& d) {
+            const T r = std::tan(d.x);
+            return d.chain(r, 1 + r * r);
+        }
+
+        friend Dual asin(const Dual& d) {
+            return d.chain(std::asin(d.x), 1 / std::sqrt((1 - d.x) * (1 + d.x)));
+        }
+
+        friend Dual acos(const Dual& d) {
+            return d.chain(std::acos(d.x), -1 / std::sqrt((1 - d.x) * (1 + d.x)));
+        }
+
+        friend Dual atan(const Dual& d) {
+            return d.chain(std::atan(d.x), 1 / (1 + d.x * d.x));
+        }
+
+        friend Dual atan2(const Dual& y, const Dual& x) {
+            const T inv = 1 / (x.x * x.x + y.x * y.x);
+            return y.chain(std::atan2(y.x, x.x), x.x * inv, x, -y.x * inv);
+        }
+    };
+
+    template <typename T, size_t N>
+    struct accumulator<Dual<T, N>> {
+        using type = Dual<accumulator_t<T>, N>;
+    };
+
+    // q as the independent variable `index` of a computation differentiated with respect to N variables.
+    template <size_t N, typename U, typename T>
+    constexpr Quantity<U, Dual<T, N>> variable(const Quantity<U, T>& q, size_t index) {
+        return Quantity<U, Dual<T, N>>(Dual<T, N>::variable(q.value, index));
+    }
+
+    // The value of q without its derivatives.
+    template <typename U, typename T, size_t N>
+    constexpr Quantity<U, T> primal(const Quantity<U, Dual<T, N>>& q) {
+        return Quantity<U, T>(q.value.x);
+    }
+
+    // dy/dx in the unit of y per unit of x, where x is the quantity that was made the variable `index`.
+    template <typename UY, typename UX, typename T, size_t N>
+    constexpr auto derivative(const Quantity<UY, Dual<T, N>>& y, const Quantity<UX, Dual<T, N>>&, size_t index) {
+        return Quantity<UY, T>(y.value.dx[index]) / Quantity<UX, T>(1);
+    }
+
+    template <typename UX, typename T, size_t N>
+    constexpr auto derivative(const Dual<T, N>& y, const Quantity<UX, Dual<T, N>>&, size_t index) {
+        return y.dx[index] / Quantity<UX, T>(1);
+    }
+}
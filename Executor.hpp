@@ -0,0 +1,222 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // Inputs below this many elements per thread are processed on the calling thread.
+    inline constexpr size_t default_parallel_grain = size_t{1} << 16;
+
+    // Fixed set of worker threads that run parallel_for jobs together with the calling thread. A job over
+    // [0, n) is first split into one contiguous range per thread, so each thread keeps touching the same memory
+    // across calls over the same data (and, with pinned threads, the same NUMA node). Threads take grain-sized
+    // chunks from the front of their own range and, once it is empty, steal chunks from the ranges of the
+    // following threads. Jobs run one at a time; parallel_for calls made from inside a job run serially.
+    struct ThreadPool {
+        // threadCount includes the calling thread. With pinThreads, on Linux, worker i is pinned to CPU i, so
+        // neighbouring threads (which steal from each other first) usually share a node.
+        explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency(), bool pinThreads = false)
+            : ranges(new Range[std::max<size_t>(threadCount, 1)]) {
+            threadCount = std::max<size_t>(threadCount, 1);
+            workers.reserve(threadCount - 1);
+            for (size_t i = 1; i < threadCount; ++i) {
+                workers.emplace_back([this, i] { workerLoop(i); });
+#if defined(__linux__)
+                if (pinThreads) {
+                    cpu_set_t set;
+                    CPU_ZERO(&set);
+                    CPU_SET(i % CPU_SETSIZE, &set);
+                    pthread_setaffinity_np(workers.back().native_handle(), sizeof(set), &set);
+                }
+#else
+                (void)pinThreads;
+#endif
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        size_t size() const {
+            return workers.size() + 1;
+        }
+
+        size_t grain() const {
+            return grainSize.load(std::memory_order_relaxed);
+        }
+
+        // Default chunk size of parallel_for, and the per-thread minimum below which bulk operations stay serial.
+        void setGrain(size_t grain) {
+            grainSize.store(std::max<size_t>(grain, 1), std::memory_order_relaxed);
+        }
+
+        // Calls body(begin, end) on disjoint chunks covering [0, n), on up to `threads` threads (0: all of them)
+        // with at least `grain` elements (0: grain()) per thread. Exceptions thrown by body are rethrown here
+        // once every chunk has finished.
+        template <typename F>
+        void parallelFor(size_t n, F&& body, size_t threads = 0, size_t grain = 0) {
+            if (grain == 0) grain = this->grain();
+            if (threads == 0 || threads > size()) threads = size();
+            threads = std::min(threads, n / grain);
+            if (threads <= 1 || insideJob()) {
+                if (n != 0) body(size_t{0}, n);
+                return;
+            }
+
+            std::lock_guard submit(submitMutex);
+            for (size_t t = 0; t < threads; ++t) {
+                ranges[t].next.store(n * t / threads, std::memory_order_relaxed);
+                ranges[t].end = n * (t + 1) / threads;
+            }
+            {
+                std::lock_guard lock(mutex);
+                using Fn = std::remove_reference_t<F>;
+                job = {const_cast<void*>(static_cast<const void*>(std::addressof(body))),
+                       [](void* f, size_t begin, size_t end) { (*static_cast<Fn*>(f))(begin, end); }};
+                participants = threads;
+                chunkSize = grain;
+                pending.store(threads - 1, std::memory_order_relaxed);
+                error = nullptr;
+                ++generation;
+            }
+            wake.notify_all();
+
+            insideJob() = true;
+            run(0);
+            insideJob() = false;
+            for (size_t left = pending.load(std::memory_order_acquire); left != 0;
+                 left = pending.load(std::memory_order_acquire)) {
+                pending.wait(left, std::memory_order_acquire);
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+    private:
+        struct alignas(64) Range {
+            std::atomic<size_t> next{0};
+            size_t end = 0;
+        };
+
+        struct Job {
+            void* body = nullptr;
+            void (*invoke)(void*, size_t, size_t) = nullptr;
+        };
+
+        std::vector<std::thread> workers;
+        std::unique_ptr<Range[]> ranges;
+        std::atomic<size_t> grainSize{default_parallel_grain};
+
+        std::mutex submitMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        Job job;
+        size_t participants = 0;
+        size_t chunkSize = 1;
+        uint64_t generation = 0;
+        bool stopping = false;
+        std::atomic<size_t> pending{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        static bool& insideJob() {
+            thread_local bool inside = false;
+            return inside;
+        }
+
+        // Drains this thread's range, then the others' in order starting from its neighbour.
+        void run(size_t self) {
+            for (size_t k = 0; k < participants; ++k) {
+                Range& range = ranges[(self + k) % participants];
+                for (size_t begin = range.next.fetch_add(chunkSize, std::memory_order_relaxed); begin < range.end;
+                     begin = range.next.fetch_add(chunkSize, std::memory_order_relaxed)) {
+                    try {
+                        job.invoke(job.body, begin, std::min(begin + chunkSize, range.end));
+                    } catch (...) {
+                        std::lock_guard lock(errorMutex);
+                        if (!error) error = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        void workerLoop(size_t index) {
+            insideJob() = true;
+            uint64_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock lock(mutex);
+                    wake.wait(lock, [&] { return stopping || generation != seen; });
+                    if (stopping) return;
+                    seen = generation;
+                    if (index >= participants) continue;
+                }
+                run(index);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pending.notify_one();
+            }
+        }
+    };
+
+    // Thread count of default_pool(), read when the pool is first used; 0 means one per hardware thread.
+    inline std::atomic<size_t> default_pool_threads{0};
+
+    // Pool shared by the library's bulk operations.
+    inline ThreadPool& default_pool() {
+        static ThreadPool pool(default_pool_threads.load() != 0 ? default_pool_threads.load()
+                                                                : std::thread::hardware_concurrency());
+        return pool;
+    }
+
+    template <typename F>
+    void parallel_for(size_t n, F&& body, size_t threads = 0, size_t grain = 0) {
+        default_pool().parallelFor(n, std::forward<F>(body), threads, grain);
+    }
+
+    // Converts every quantity of `in` to the unit and value type of `out`, which holds at least as many elements,
+    // with the conversion factor folded at compile time.
+    template <std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+        requires is_quantity_v<std::ranges::range_value_t<In>> && is_quantity_v<std::ranges::range_value_t<Out>>
+    void convert(const In& in, Out&& out, size_t threads = 0) {
+        using QO = std::ranges::range_value_t<Out>;
+        const auto* src = std::ranges::data(in);
+        QO* dst = std::ranges::data(out);
+        parallel_for(std::ranges::size(in), [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) dst[i] = QO(src[i]);
+        }, threads);
+    }
+}
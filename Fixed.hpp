@@ -0,0 +1,146 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // Binary fixed-point number stored as Rep with FracBits fractional bits, e.g. Fixed<int32_t, 16> is Q16.16.
+    // Used as a Quantity value type, unit conversions between fixed-point and integer quantities are done with
+    // exact integer ratio arithmetic (see convert_exact).
+    template <typename Rep, int FracBits>
+    struct Fixed {
+        static_assert(std::is_integral_v<Rep> && std::is_signed_v<Rep>, "Fixed requires a signed integer Rep.");
+        static_assert(FracBits > 0 && FracBits < static_cast<int>(sizeof(Rep) * 8) - 1, "Invalid FracBits.");
+
+        using rep = Rep;
+        static constexpr int frac_bits = FracBits;
+        static constexpr Rep one = Rep{1} << FracBits;
+
+        Rep raw;
+
+        constexpr Fixed() : raw(0) {
+        }
+
+        template <typename V> requires std::is_integral_v<V>
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr Fixed(V v) : raw(static_cast<Rep>(static_cast<Rep>(v) * one)) {
+        }
+
+        template <typename V> requires std::is_floating_point_v<V>
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr Fixed(V v) : raw(static_cast<Rep>(v * one + (v < 0 ? -0.5 : 0.5))) {
+        }
+
+        static constexpr Fixed fromRaw(Rep r) {
+            Fixed f;
+            f.raw = r;
+            return f;
+        }
+
+        template <typename V> requires std::is_floating_point_v<V>
+        constexpr explicit operator V() const {
+            return static_cast<V>(raw) / static_cast<V>(one);
+        }
+
+        template <typename V> requires std::is_integral_v<V>
+        constexpr explicit operator V() const {
+            return static_cast<V>(raw / one);
+        }
+
+        constexpr Fixed operator+(const Fixed& rhs) const {
+            return fromRaw(static_cast<Rep>(raw + rhs.raw));
+        }
+
+        constexpr Fixed operator-(const Fixed& rhs) const {
+            return fromRaw(static_cast<Rep>(raw - rhs.raw));
+        }
+
+        constexpr Fixed operator*(const Fixed& rhs) const {
+            return fromRaw(static_cast<Rep>(static_cast<Wide>(raw) * rhs.raw >> FracBits));
+        }
+
+        constexpr Fixed operator/(const Fixed& rhs) const {
+            return fromRaw(static_cast<Rep>((static_cast<Wide>(raw) << FracBits) / rhs.raw));
+        }
+
+        constexpr Fixed operator+() const {
+            return *this;
+        }
+
+        constexpr Fixed operator-() const {
+            return fromRaw(static_cast<Rep>(-raw));
+        }
+
+        constexpr Fixed& operator+=(const Fixed& rhs) {
+            return *this = *this + rhs;
+        }
+
+        constexpr Fixed& operator-=(const Fixed& rhs) {
+            return *this = *this - rhs;
+        }
+
+        constexpr Fixed& operator*=(const Fixed& rhs) {
+            return *this = *this * rhs;
+        }
+
+        constexpr Fixed& operator/=(const Fixed& rhs) {
+            return *this = *this / rhs;
+        }
+
+        constexpr auto operator<=>(const Fixed&) const = default;
+
+        friend std::ostream& operator<<(std::ostream& os, const Fixed& f) {
+            return os << static_cast<double>(f);
+        }
+
+        friend constexpr Fixed abs(const Fixed& f) {
+            return f.raw < 0 ? -f : f;
+        }
+
+        friend constexpr Fixed floor(const Fixed& f) {
+            return fromRaw(static_cast<Rep>(f.raw & ~(one - 1)));
+        }
+
+        friend constexpr Fixed ceil(const Fixed& f) {
+            return fromRaw(static_cast<Rep>((f.raw + one - 1) & ~(one - 1)));
+        }
+
+        friend constexpr Fixed fmod(const Fixed& a, const Fixed& b) {
+            return fromRaw(static_cast<Rep>(a.raw % b.raw));
+        }
+
+    private:
+        using Wide = std::conditional_t<(sizeof(Rep) < 8), int64_t, exact_wide_t>;
+    };
+
+    template <typename Rep, int FracBits>
+    struct exact_value_traits<Fixed<Rep, FracBits>> {
+        static constexpr bool value = true;
+        static constexpr int frac_bits = FracBits;
+        using rep = Rep;
+
+        static constexpr rep to_raw(const Fixed<Rep, FracBits>& v) {
+            return v.raw;
+        }
+
+        static constexpr Fixed<Rep, FracBits> from_raw(rep r) {
+            return Fixed<Rep, FracBits>::fromRaw(r);
+        }
+    };
+
+    using Q16_16 = Fixed<int32_t, 16>;
+    using Q32_32 = Fixed<int64_t, 32>;
+}
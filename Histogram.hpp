@@ -0,0 +1,224 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // HDR-style log-linear histogram of an integer quantity such as with_value_t<nano<s>, int64_t>; one unit of Q
+    // is the smallest distinguishable value. Values below 2^SubBucketBits get a bucket each, every larger power of
+    // two is split into 2^(SubBucketBits - 1) equal buckets, so the relative error stays below 2^-(SubBucketBits - 1)
+    // over the whole 63-bit range. Negative values are recorded as 0.
+    template <typename Q, int SubBucketBits = 7>
+    struct Histogram {
+        static_assert(is_quantity_v<Q> && std::is_integral_v<typename Q::value_type>,
+                      "Histogram requires a Quantity with an integer value type.");
+        static_assert(SubBucketBits >= 2 && SubBucketBits <= 16, "Invalid SubBucketBits.");
+
+        static constexpr size_t subBucketCount = size_t{1} << SubBucketBits;
+        static constexpr size_t halfCount = subBucketCount / 2;
+        static constexpr size_t bucketCount = subBucketCount + (64 - SubBucketBits) * halfCount;
+
+        Histogram() : counts(bucketCount) {
+        }
+
+        static constexpr size_t bucketIndex(uint64_t v) {
+            const int shift = std::max(static_cast<int>(std::bit_width(v)) - SubBucketBits, 0);
+            if (shift == 0) return static_cast<size_t>(v);
+            return subBucketCount + (shift - 1) * halfCount + static_cast<size_t>((v >> shift) - halfCount);
+        }
+
+        static constexpr uint64_t lowestEquivalent(size_t index) {
+            if (index < subBucketCount) return index;
+            const size_t k = index - subBucketCount;
+            const int shift = static_cast<int>(k / halfCount) + 1;
+            return static_cast<uint64_t>(k % halfCount + halfCount) << shift;
+        }
+
+        static constexpr uint64_t highestEquivalent(size_t index) {
+            if (index < subBucketCount) return index;
+            const int shift = static_cast<int>((index - subBucketCount) / halfCount) + 1;
+            return lowestEquivalent(index) + ((uint64_t{1} << shift) - 1);
+        }
+
+        void record(const Q& q, uint64_t n = 1) {
+            const uint64_t v = q.value < 0 ? 0 : static_cast<uint64_t>(q.value);
+            counts[bucketIndex(v)] += n;
+            total += n;
+            minValue = std::min(minValue, v);
+            maxValue = std::max(maxValue, v);
+        }
+
+        // Other integer time units are converted with their exact ratio, e.g. nanoseconds into a microsecond
+        // histogram are truncated, never rounded through floating point.
+        template <typename U, typename V> requires (!std::is_same_v<Quantity<U, V>, Q>)
+        void record(const Quantity<U, V>& q, uint64_t n = 1) {
+            record(Q{q}, n);
+        }
+
+        void merge(const Histogram& other) {
+            for (size_t i = 0; i < bucketCount; ++i) counts[i] += other.counts[i];
+            total += other.total;
+            minValue = std::min(minValue, other.minValue);
+            maxValue = std::max(maxValue, other.maxValue);
+        }
+
+        void reset() {
+            std::fill(counts.begin(), counts.end(), 0);
+            total = 0;
+            minValue = std::numeric_limits<uint64_t>::max();
+            maxValue = 0;
+        }
+
+        uint64_t count() const {
+            return total;
+        }
+
+        uint64_t bucket(size_t index) const {
+            return counts[index];
+        }
+
+        // Zero while empty.
+        Q min() const {
+            return total == 0 ? Q(0) : raw(minValue);
+        }
+
+        Q max() const {
+            return raw(maxValue);
+        }
+
+        // Midpoint of every bucket weighted by its count.
+        Quantity<typename Q::u, float_t> mean() const {
+            if (total == 0) return Quantity<typename Q::u, float_t>(0);
+            float_t sum = 0;
+            for (size_t i = 0; i < bucketCount; ++i) {
+                if (counts[i] == 0) continue;
+                float_t low = static_cast<float_t>(lowestEquivalent(i));
+                float_t high = static_cast<float_t>(highestEquivalent(i));
+                sum += (low + high) / 2 * static_cast<float_t>(counts[i]);
+            }
+            return Quantity<typename Q::u, float_t>(sum / static_cast<float_t>(total));
+        }
+
+        // The highest value equivalent to the value at percentile p (0 to 100), capped at max(), the way
+        // HdrHistogram reports percentiles. Zero while empty.
+        Q percentile(float_t p) const {
+            if (total == 0) return Q(0);
+            p = std::clamp<float_t>(p, 0, 100);
+            const float_t target = p / 100 * static_cast<float_t>(total);
+            const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(target + 0.5), 1);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucketCount; ++i) {
+                seen += counts[i];
+                if (seen >= rank) return raw(std::min(highestEquivalent(i), maxValue));
+            }
+            return raw(maxValue);
+        }
+
+    private:
+        template <typename, int>
+        friend struct ShardedHistogram;
+
+        std::vector<uint64_t> counts;
+        uint64_t total = 0;
+        uint64_t minValue = std::numeric_limits<uint64_t>::max();
+        uint64_t maxValue = 0;
+
+        static Q raw(uint64_t v) {
+            return Q(static_cast<typename Q::value_type>(v));
+        }
+    };
+
+    // Histogram recorded from many threads. Each thread records into the shard its id hashes to, with relaxed
+    // atomic increments that stay uncontended as long as there are at least as many shards as threads; the
+    // shards are only combined when reading.
+    template <typename Q, int SubBucketBits = 7>
+    struct ShardedHistogram {
+        using histogram_type = Histogram<Q, SubBucketBits>;
+
+        explicit ShardedHistogram(size_t shardCount = std::thread::hardware_concurrency())
+            : shards(std::max<size_t>(shardCount, 1)) {
+        }
+
+        void record(const Q& q, uint64_t n = 1) {
+            const uint64_t v = q.value < 0 ? 0 : static_cast<uint64_t>(q.value);
+            Shard& shard = shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards.size()];
+            shard.counts[histogram_type::bucketIndex(v)].fetch_add(n, std::memory_order_relaxed);
+            shard.total.fetch_add(n, std::memory_order_relaxed);
+            uint64_t current = shard.minValue.load(std::memory_order_relaxed);
+            while (v < current && !shard.minValue.compare_exchange_weak(current, v, std::memory_order_relaxed)) {
+            }
+            current = shard.maxValue.load(std::memory_order_relaxed);
+            while (v > current && !shard.maxValue.compare_exchange_weak(current, v, std::memory_order_relaxed)) {
+            }
+        }
+
+        template <typename U, typename V> requires (!std::is_same_v<Quantity<U, V>, Q>)
+        void record(const Quantity<U, V>& q, uint64_t n = 1) {
+            record(Q{q}, n);
+        }
+
+        // Merges the shards into a plain histogram. Recording may continue meanwhile; the snapshot then holds
+        // some of the concurrent values.
+        histogram_type snapshot() const {
+            histogram_type result;
+            for (const auto& shard : shards) {
+                for (size_t i = 0; i < histogram_type::bucketCount; ++i) {
+                    result.counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+                }
+                result.total += shard.total.load(std::memory_order_relaxed);
+                result.minValue = std::min(result.minValue, shard.minValue.load(std::memory_order_relaxed));
+                result.maxValue = std::max(result.maxValue, shard.maxValue.load(std::memory_order_relaxed));
+            }
+            return result;
+        }
+
+    private:
+        struct alignas(64) Shard {
+            std::unique_ptr<std::atomic<uint64_t>[]> counts{new std::atomic<uint64_t>[histogram_type::bucketCount]{}};
+            std::atomic<uint64_t> total{0};
+            std::atomic<uint64_t> minValue{std::numeric_limits<uint64_t>::max()};
+            std::atomic<uint64_t> maxValue{0};
+        };
+
+        std::vector<Shard> shards;
+    };
+
+    // Records the time from construction to destruction into a histogram, read with extra_functions::get_time_ns
+    // so the duration stays an integer number of nanoseconds.
+    template <typename H>
+    struct ScopedTimer {
+        explicit ScopedTimer(H& histogram) : histogram(histogram), start(extra_functions::get_time_ns()) {
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer() {
+            histogram.record(extra_functions::get_time_ns() - start);
+        }
+
+    private:
+        H& histogram;
+        decltype(extra_functions::get_time_ns()) start;
+    };
+}
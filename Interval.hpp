@@ -0,0 +1,285 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // A value one or two ulps below v, computed without branches so that interval loops vectorize: the step is at
+    // least the ulp of any finite v, and denorm_min near zero. +inf steps to below the largest finite value; -inf and
+    // NaN are kept.
+    template <typename T>
+    constexpr T round_down(T v) {
+        const T capped = std::min(v, std::numeric_limits<T>::max());
+        return capped - ((capped < 0 ? -capped : capped) * std::numeric_limits<T>::epsilon() +
+            std::numeric_limits<T>::min());
+    }
+
+    template <typename T>
+    constexpr T round_up(T v) {
+        return -round_down(-v);
+    }
+
+    // Closed interval [lo, hi] containing the exact result of every operation on the intervals it came from. Each
+    // result is computed in round-to-nearest and then rounded outward by at least one ulp (twice for the libm
+    // functions, whose results are assumed to be within one ulp), which contains the result of directed rounding
+    // without switching the floating-point rounding mode. Bounds are lost under -ffast-math.
+    //
+    // Comparisons hold only if they hold for every pair of values within the bounds, so a < b and a >= b can both
+    // be false, and a == b only for equal single-point intervals.
+    template <typename T>
+    struct Interval {
+        static_assert(std::is_floating_point_v<T>, "Interval requires a floating-point T.");
+
+        using scalar_type = T;
+
+        T lo;
+        T hi;
+
+        constexpr Interval() : lo(0), hi(0) {
+        }
+
+        // Integers that T cannot represent exactly get the two neighbouring values as bounds.
+        template <typename V> requires std::is_arithmetic_v<V>
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr Interval(V v) : lo(static_cast<T>(v)), hi(static_cast<T>(v)) {
+            if constexpr (std::is_integral_v<V> && std::numeric_limits<V>::digits > std::numeric_limits<T>::digits) {
+                constexpr V exact = V{1} << std::numeric_limits<T>::digits;
+                bool inexact = v > exact;
+                // Negating exact would wrap for unsigned V, which has no lower bound to check anyway.
+                if constexpr (std::is_signed_v<V>) inexact = inexact || v < -exact;
+                if (inexact) {
+                    lo = round_down(lo);
+                    hi = round_up(hi);
+                }
+            } else if constexpr (std::is_floating_point_v<V> && sizeof(V) > sizeof(T)) {
+                if (static_cast<V>(lo) != v) {
+                    lo = static_cast<V>(lo) > v ? round_down(lo) : lo;
+                    hi = static_cast<V>(hi) < v ? round_up(hi) : hi;
+                }
+            }
+        }
+
+        constexpr Interval(T lo, T hi) : lo(lo), hi(hi) {
+        }
+
+        template <typename U>
+        constexpr explicit Interval(const Interval<U>& other) : Interval(other.lo) {
+            hi = Interval(other.hi).hi;
+        }
+
+        // Interval of the values within `radius` of `center`.
+        static constexpr Interval around(T center, T radius) {
+            return Interval(round_down(center - radius), round_up(center + radius));
+        }
+
+        constexpr T mid() const {
+            return lo + (hi - lo) / 2;
+        }
+
+        constexpr T width() const {
+            return hi - lo;
+        }
+
+        constexpr bool contains(T v) const {
+            return lo <= v && v <= hi;
+        }
+
+        friend constexpr Interval operator+(const Interval& a, const Interval& b) {
+            return Interval(round_down(a.lo + b.lo), round_up(a.hi + b.hi));
+        }
+
+        friend constexpr Interval operator-(const Interval& a, const Interval& b) {
+            return Interval(round_down(a.lo - b.hi), round_up(a.hi - b.lo));
+        }
+
+        // The four bound products paired into min and max, without branching on the signs.
+        friend constexpr Interval operator*(const Interval& a, const Interval& b) {
+            const T p0 = a.lo * b.lo, p1 = a.lo * b.hi, p2 = a.hi * b.lo, p3 = a.hi * b.hi;
+            return Interval(round_down(std::min(std::min(p0, p1), std::min(p2, p3))),
+                            round_up(std::max(std::max(p0, p1), std::max(p2, p3))));
+        }
+
+        // Division by an interval containing zero gives the whole real line.
+        friend constexpr Interval operator/(const Interval& a, const Interval& b) {
+            if (b.lo <= 0 && b.hi >= 0) {
+                return Interval(-std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity());
+            }
+            const T q0 = a.lo / b.lo, q1 = a.lo / b.hi, q2 = a.hi / b.lo, q3 = a.hi / b.hi;
+            return Interval(round_down(std::min(std::min(q0, q1), std::min(q2, q3))),
+                            round_up(std::max(std::max(q0, q1), std::max(q2, q3))));
+        }
+
+        constexpr Interval operator+() const {
+            return *this;
+        }
+
+        constexpr Interval operator-() const {
+            return Interval(-hi, -lo);
+        }
+
+        constexpr Interval& operator+=(const Interval& rhs) {
+            return *this = *this + rhs;
+        }
+
+        constexpr Interval& operator-=(const Interval& rhs) {
+            return *this = *this - rhs;
+        }
+
+        constexpr Interval& operator*=(const Interval& rhs) {
+            return *this = *this * rhs;
+        }
+
+        constexpr Interval& operator/=(const Interval& rhs) {
+            return *this = *this / rhs;
+        }
+
+        friend constexpr bool operator==(const Interval& a, const Interval& b) {
+            return a.lo == a.hi && b.lo == b.hi && a.lo == b.lo;
+        }
+
+        friend constexpr bool operator<(const Interval& a, const Interval& b) {
+            return a.hi < b.lo;
+        }
+
+        friend constexpr bool operator<=(const Interval& a, const Interval& b) {
+            return a.hi <= b.lo;
+        }
+
+        friend constexpr bool operator>(const Interval& a, const Interval& b) {
+            return a.lo > b.hi;
+        }
+
+        friend constexpr bool operator>=(const Interval& a, const Interval& b) {
+            return a.lo >= b.hi;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const Interval& i) {
+            return os << "[" << i.lo << ", " << i.hi << "]";
+        }
+
+        friend constexpr Interval abs(const Interval& i) {
+            if (i.lo >= 0) return i;
+            if (i.hi <= 0) return -i;
+            return Interval(0, std::max(-i.lo, i.hi));
+        }
+
+        friend Interval floor(const Interval& i) {
+            return Interval(std::floor(i.lo), std::floor(i.hi));
+        }
+
+        friend Interval ceil(const Interval& i) {
+            return Interval(std::ceil(i.lo), std::ceil(i.hi));
+        }
+
+        // sqrt is correctly rounded, so one step suffices. Negative parts of the interval are outside the domain
+        // and left out.
+        friend Interval sqrt(const Interval& i) {
+            return Interval(std::max(T(0), round_down(std::sqrt(std::max(i.lo, T(0))))), round_up(std::sqrt(i.hi)));
+        }
+
+        friend Interval cbrt(const Interval& i) {
+            return monotonic(i, [](T v) { return std::cbrt(v); });
+        }
+
+        // For non-negative intervals.
+        friend Interval pow(const Interval& i, T p) {
+            const Interval base(std::max(i.lo, T(0)), std::max(i.hi, T(0)));
+            return monotonic(base, [p](T v) { return std::pow(v, p); });
+        }
+
+        friend Interval exp(const Interval& i) {
+            return monotonic(i, [](T v) { return std::exp(v); });
+        }
+
+        friend Interval log(const Interval& i) {
+            return monotonic(i, [](T v) { return std::log(v); });
+        }
+
+        friend Interval hypot(const Interval& a, const Interval& b) {
+            return sqrt(square(a) + square(b));
+        }
+
+        friend Interval hypot(const Interval& a, const Interval& b, const Interval& c) {
+            return sqrt(square(a) + square(b) + square(c));
+        }
+
+        friend Interval sin(const Interval& i) {
+            return cos(i - half_pi());
+        }
+
+        // cos reaches 1 at the even and -1 at the odd multiples of pi inside the interval, and is monotonic in
+        // between.
+        friend Interval cos(const Interval& i) {
+            // From 2^digits on, T has no fractional bits left to tell the multiples of pi apart (and ++k below
+            // would stop advancing), so such bounds only give the full range.
+            constexpr T exact = 2 / std::numeric_limits<T>::epsilon();
+            if (!(i.hi - i.lo < 2 * pi) || !(std::abs(i.lo) < exact && std::abs(i.hi) < exact)) return Interval(-1, 1);
+            const T first = std::ceil(round_down(i.lo / pi)), last = std::floor(round_up(i.hi / pi));
+            if (last - first > 2) return Interval(-1, 1);
+            const T a = std::cos(i.lo), b = std::cos(i.hi);
+            Interval r(round_down(round_down(std::min(a, b))), round_up(round_up(std::max(a, b))));
+            for (T k = first; k <= last; ++k) {
+                if (std::fmod(k, T(2)) == 0) r.hi = 1;
+                else r.lo = -1;
+            }
+            return Interval(std::max(r.lo, T(-1)), std::min(r.hi, T(1)));
+        }
+
+        friend Interval asin(const Interval& i) {
+            return monotonic(Interval(std::max(i.lo, T(-1)), std::min(i.hi, T(1))), [](T v) { return std::asin(v); });
+        }
+
+        friend Interval acos(const Interval& i) {
+            return monotonic(Interval(std::max(i.lo, T(-1)), std::min(i.hi, T(1))), [](T v) { return std::acos(v); });
+        }
+
+        friend Interval atan(const Interval& i) {
+            return monotonic(i, [](T v) { return std::atan(v); });
+        }
+
+    private:
+        static constexpr Interval half_pi() {
+            return Interval(round_down(static_cast<T>(pi / 2)), round_up(static_cast<T>(pi / 2)));
+        }
+
+        static constexpr Interval square(const Interval& i) {
+            const Interval a = abs(i);
+            return Interval(round_down(a.lo * a.lo), round_up(a.hi * a.hi));
+        }
+
+        // f of the bounds rounded outward twice, for f monotonic over the interval.
+        template <typename F>
+        static Interval monotonic(const Interval& i, F f) {
+            const T a = f(i.lo), b = f(i.hi);
+            return Interval(round_down(round_down(std::min(a, b))), round_up(round_up(std::max(a, b))));
+        }
+    };
+
+    template <typename T>
+    inline constexpr bool is_bounded_value_v<Interval<T>> = true;
+
+    template <typename U, typename T>
+    constexpr Quantity<U, T> lower(const Quantity<U, Interval<T>>& q) {
+        return Quantity<U, T>(q.value.lo);
+    }
+
+    template <typename U, typename T>
+    constexpr Quantity<U, T> upper(const Quantity<U, Interval<T>>& q) {
+        return Quantity<U, T>(q.value.hi);
+    }
+}
@@ -0,0 +1,236 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    enum class Interpolation {
+        Linear,
+        // Cubic Hermite with finite-difference slopes; passes through every point.
+        Cubic
+    };
+
+    // Tabulated function from XQ to YQ. The points may be given in any units of the same dimensions and are
+    // converted once when the table is built; lookups take and return quantities in any compatible unit.
+    // Arguments outside the table are clamped to its ends.
+    //
+    // Every segment is stored as the cubic c3 f^3 + c2 f^2 + c1 f + c0 of its local coordinate f in [0, 1]
+    // (linear tables have zero c3 and c2), so both kinds evaluate with the same branch-free code.
+    template <typename XQ, typename YQ>
+    struct LookupTable {
+        static_assert(is_quantity_v<XQ> && is_quantity_v<YQ>, "LookupTable requires Quantity types.");
+        static_assert(std::is_floating_point_v<typename XQ::value_type> &&
+                      std::is_floating_point_v<typename YQ::value_type>,
+                      "LookupTable requires floating-point quantities.");
+
+        using x_value = typename XQ::value_type;
+        using y_value = typename YQ::value_type;
+
+        // Points at strictly increasing xs.
+        template <std::ranges::input_range RX, std::ranges::input_range RY>
+        LookupTable(const RX& xs, const RY& ys, Interpolation interpolation = Interpolation::Linear) {
+            for (const auto& x : xs) knots.push_back(XQ{x}.value);
+            std::vector<y_value> values = convertValues(ys);
+            if (knots.size() != values.size()) throw std::invalid_argument("LookupTable: xs and ys differ in size.");
+            if (knots.size() < 2) throw std::invalid_argument("LookupTable: at least two points are required.");
+            for (size_t i = 0; i + 1 < knots.size(); ++i) {
+                if (!(knots[i] < knots[i + 1])) throw std::invalid_argument("LookupTable: xs must be increasing.");
+                invWidths.push_back(1 / (knots[i + 1] - knots[i]));
+            }
+            build(values, interpolation);
+        }
+
+        // Points at equally spaced xs from first to last, which are located with a multiply instead of a search.
+        template <std::ranges::input_range RY>
+        static LookupTable uniform(XQ first, XQ last, const RY& ys,
+                                   Interpolation interpolation = Interpolation::Linear) {
+            std::vector<y_value> values = convertValues(ys);
+            if (values.size() < 2) throw std::invalid_argument("LookupTable: at least two points are required.");
+            if (!(first < last)) throw std::invalid_argument("LookupTable: first must be less than last.");
+            LookupTable table;
+            table.x0 = first.value;
+            table.x1 = last.value;
+            table.invStep = static_cast<x_value>(values.size() - 1) / (last.value - first.value);
+            table.build(values, interpolation);
+            return table;
+        }
+
+        // Samples f at n equally spaced points from first to last.
+        template <typename F>
+            requires requires(F f, XQ x) { YQ{f(x)}; }
+        static LookupTable sample(XQ first, XQ last, size_t n, F&& f,
+                                  Interpolation interpolation = Interpolation::Linear) {
+            std::vector<YQ> ys;
+            ys.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                x_value t = n < 2 ? 0 : static_cast<x_value>(i) / static_cast<x_value>(n - 1);
+                ys.push_back(YQ{f(XQ(first.value + (last.value - first.value) * t))});
+            }
+            return uniform(first, last, ys, interpolation);
+        }
+
+        size_t size() const {
+            return c0.size() + 1;
+        }
+
+        XQ min() const {
+            return XQ(knots.empty() ? x0 : knots.front());
+        }
+
+        XQ max() const {
+            return XQ(knots.empty() ? x1 : knots.back());
+        }
+
+        template <typename U, typename V>
+            requires std::is_same_v<pure_unit_t<U>, pure_unit_t<typename XQ::u>>
+        YQ operator()(const Quantity<U, V>& x) const {
+            return YQ(evaluate(XQ{x}.value));
+        }
+
+        // out[i] = table(xs[i]). Both ranges are contiguous and may use any units of the right dimensions; the unit
+        // conversions are folded into one multiply each. Uniform tables evaluate in a loop the compiler can
+        // vectorize (with gathers, e.g. -mavx2).
+        template <std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+        void operator()(const In& xs, Out&& out) const {
+            using QI = std::ranges::range_value_t<In>;
+            using QO = std::ranges::range_value_t<Out>;
+            static_assert(std::is_same_v<pure_unit_t<typename QI::u>, pure_unit_t<typename XQ::u>>,
+                          "LookupTable input has the wrong dimension.");
+            static_assert(std::is_same_v<pure_unit_t<typename QO::u>, pure_unit_t<typename YQ::u>>,
+                          "LookupTable output has the wrong dimension.");
+            constexpr auto in_scale = conversion_factor<x_value, typename QI::u, typename XQ::u>();
+            constexpr auto out_scale = conversion_factor<y_value, typename YQ::u, typename QO::u>();
+
+            const QI* src = std::ranges::data(xs);
+            QO* dst = std::ranges::data(out);
+            const size_t n = std::ranges::size(xs);
+            if (knots.empty()) {
+                // Evaluated block by block into a local buffer: gathers from the coefficients would otherwise
+                // possibly alias the stores to out, which keeps GCC from vectorizing.
+                constexpr size_t Block = 64;
+                const x_value last = static_cast<x_value>(c0.size());
+                const x_value start = x0, scale = invStep;
+                const y_value *a0 = c0.data(), *a1 = c1.data(), *a2 = c2.data(), *a3 = c3.data();
+                for (size_t base = 0; base < n; base += Block) {
+                    const size_t len = std::min(Block, n - base);
+                    alignas(64) y_value ys[Block];
+                    for (size_t j = 0; j < len; ++j) {
+                        x_value t = (static_cast<x_value>(src[base + j].value) * in_scale - start) * scale;
+                        t = std::min(std::max(t, x_value(0)), last);
+                        int32_t k = std::min(static_cast<int32_t>(t), static_cast<int32_t>(last) - 1);
+                        y_value f = static_cast<y_value>(t - static_cast<x_value>(k));
+                        ys[j] = ((a3[k] * f + a2[k]) * f + a1[k]) * f + a0[k];
+                    }
+                    for (size_t j = 0; j < len; ++j) {
+                        dst[base + j] = QO(static_cast<typename QO::value_type>(ys[j] * out_scale));
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    y_value y = evaluate(static_cast<x_value>(src[i].value) * in_scale);
+                    dst[i] = QO(static_cast<typename QO::value_type>(y * out_scale));
+                }
+            }
+        }
+
+    private:
+        // Uniform tables leave knots empty.
+        std::vector<x_value> knots;
+        std::vector<x_value> invWidths;
+        x_value x0 = 0;
+        x_value x1 = 0;
+        x_value invStep = 0;
+        std::vector<y_value> c0, c1, c2, c3;
+
+        LookupTable() = default;
+
+        template <typename RY>
+        static std::vector<y_value> convertValues(const RY& ys) {
+            std::vector<y_value> values;
+            for (const auto& y : ys) values.push_back(YQ{y}.value);
+            return values;
+        }
+
+        x_value width(size_t i) const {
+            return knots.empty() ? 1 / invStep : knots[i + 1] - knots[i];
+        }
+
+        void build(const std::vector<y_value>& ys, Interpolation interpolation) {
+            const size_t segments = ys.size() - 1;
+            c0.resize(segments);
+            c1.resize(segments);
+            c2.resize(segments, 0);
+            c3.resize(segments, 0);
+            for (size_t i = 0; i < segments; ++i) {
+                c0[i] = ys[i];
+                c1[i] = ys[i + 1] - ys[i];
+            }
+            if (interpolation == Interpolation::Linear) return;
+
+            // Slopes per unit of x from the secants d and widths h of the neighbouring segments, second-order
+            // accurate also on non-uniform grids: (h1 d0 + h0 d1) / (h0 + h1) inside, the matching one-sided
+            // three-point formula at the ends.
+            std::vector<y_value> d(segments), h(segments);
+            for (size_t i = 0; i < segments; ++i) {
+                h[i] = static_cast<y_value>(width(i));
+                d[i] = c1[i] / h[i];
+            }
+            std::vector<y_value> slopes(ys.size());
+            if (segments == 1) {
+                slopes[0] = slopes[1] = d[0];
+            } else {
+                for (size_t i = 1; i < segments; ++i) {
+                    slopes[i] = (h[i] * d[i - 1] + h[i - 1] * d[i]) / (h[i - 1] + h[i]);
+                }
+                slopes[0] = ((2 * h[0] + h[1]) * d[0] - h[0] * d[1]) / (h[0] + h[1]);
+                const size_t e = segments - 1;
+                slopes[segments] = ((2 * h[e] + h[e - 1]) * d[e] - h[e] * d[e - 1]) / (h[e] + h[e - 1]);
+            }
+            for (size_t i = 0; i < segments; ++i) {
+                y_value m0 = h[i] * slopes[i], m1 = h[i] * slopes[i + 1];
+                c3[i] = 2 * ys[i] + m0 - 2 * ys[i + 1] + m1;
+                c2[i] = -3 * ys[i] - 2 * m0 + 3 * ys[i + 1] - m1;
+                c1[i] = m0;
+            }
+        }
+
+        y_value evaluate(x_value x) const {
+            size_t k;
+            x_value f;
+            if (knots.empty()) {
+                const x_value last = static_cast<x_value>(c0.size());
+                x_value t = std::min(std::max((x - x0) * invStep, x_value(0)), last);
+                k = std::min(static_cast<size_t>(t), c0.size() - 1);
+                f = t - static_cast<x_value>(k);
+            } else {
+                // Branch-free binary search for the last knot at or below x.
+                k = 0;
+                size_t len = c0.size();
+                while (len > 1) {
+                    size_t half = len / 2;
+                    k = knots[k + half] <= x ? k + half : k;
+                    len -= half;
+                }
+                f = std::min(std::max((x - knots[k]) * invWidths[k], x_value(0)), x_value(1));
+            }
+            y_value t = static_cast<y_value>(f);
+            return ((c3[k] * t + c2[k]) * t + c1[k]) * t + c0[k];
+        }
+    };
+}
@@ -11,15 +11,28 @@
 
 #pragma once
 #include <array>
+#include <algorithm>
 #include <iostream>
+#include <span>
+#include <utility>
 
+#include "Executor.hpp"
 #include "Vector.hpp"
 
+template <size_t Rows, size_t Cols, typename T>
+struct Matrix;
+
+template <typename T>
+inline constexpr bool is_matrix_v = false;
+
+template <size_t Rows, size_t Cols, typename T>
+inline constexpr bool is_matrix_v<Matrix<Rows, Cols, T>> = true;
+
 template <size_t Rows, size_t Cols, typename T>
 struct Matrix {
     std::array<T, Rows * Cols> elements;
 
-    constexpr Matrix() : elements{} {
+    constexpr Matrix() : elements() {
     }
 
     template <typename... Args>
@@ -115,12 +128,16 @@ struct Matrix {
         return *this;
     }
 
+    // Elements of the product have the type of T * T, so units multiply and small integers promote.
+    using product_type = decltype(std::declval<T>() * std::declval<T>());
+
     template <size_t OtherCols>
     constexpr auto operator*(const Matrix<Cols, OtherCols, T>& other) const {
-        Matrix<Rows, OtherCols, T> result;
+        using R = product_type;
+        Matrix<Rows, OtherCols, R> result;
         for (size_t r = 0; r < Rows; ++r) {
             for (size_t c = 0; c < OtherCols; ++c) {
-                T sum = T{0};
+                R sum{};
                 for (size_t k = 0; k < Cols; ++k) {
                     sum += (*this)(r, k) * other(k, c);
                 }
@@ -130,10 +147,11 @@ struct Matrix {
         return result;
     }
 
-    constexpr Vector<Rows, T> operator*(const Vector<Cols, T>& vec) const {
-        Vector<Rows, T> result;
+    constexpr Vector<Rows, product_type> operator*(const Vector<Cols, T>& vec) const {
+        using R = product_type;
+        Vector<Rows, R> result;
         for (size_t r = 0; r < Rows; ++r) {
-            T sum = T{0};
+            R sum{};
             for (size_t k = 0; k < Cols; ++k) {
                 sum += (*this)(r, k) * vec[k];
             }
@@ -142,6 +160,15 @@ struct Matrix {
         return result;
     }
 
+    // out[i] = *this * in[i] for every vector of `in`, in the product element type; out holds at least as many
+    // elements. Large batches are split across `threads` threads (0: all of them).
+    void transform(std::span<const Vector<Cols, T>> in, std::span<Vector<Rows, product_type>> out,
+                   size_t threads = 0) const {
+        Unit::parallel_for(in.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) out[i] = *this * in[i];
+        }, threads, std::max<size_t>(Unit::default_pool().grain() / (Rows * Cols), 1));
+    }
+
     constexpr Matrix<Cols, Rows, T> transposed() const {
         Matrix<Cols, Rows, T> result;
         for (size_t r = 0; r < Rows; ++r) {
@@ -184,7 +211,9 @@ struct Matrix {
 
     auto operator<=>(const Matrix&) const = default;
 
-    friend auto operator*(auto scalar, const Matrix& mat) {
+    // Matrices are excluded so that a product of two matrices resolves to the member operator*.
+    template <typename S> requires (!is_matrix_v<S>)
+    friend auto operator*(S scalar, const Matrix& mat) {
         return mat * scalar;
     }
 };
@@ -0,0 +1,265 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+#include <type_traits>
+
+#include "Reduce.hpp"
+#include "Unit.hpp"
+
+// Integrators for many independent bodies stored as structure-of-arrays ranges of quantities, updated in place.
+// The derivative functions are called per element with its index, f(t, y, i), so they can read other per-body
+// arrays. Their results must have the unit of the state over time (m -> m/s -> m/s^2), which is checked at
+// compile time. Stage values live in registers, so a step allocates nothing, and large inputs are split across
+// `threads` threads (0: all of them).
+namespace Unit::ode {
+    template <typename X, typename T>
+    using derivative_t = decltype(std::declval<X>() / std::declval<T>());
+
+    template <typename R>
+    concept state_range = std::ranges::contiguous_range<R> && is_quantity_v<std::ranges::range_value_t<R>>;
+
+    // Raw value of a derivative function's result in the unit of D.
+    template <typename D, typename R>
+    constexpr auto derivative_value(const R& r) {
+        static_assert(is_quantity_v<R> && std::is_same_v<pure_unit_t<typename R::u>, pure_unit_t<typename D::u>>,
+                      "The derivative function returns a quantity of the wrong dimension.");
+        return D{r}.value;
+    }
+
+    template <typename F>
+    void for_chunks(size_t n, size_t threads, F&& chunk) {
+        parallel_for(n, std::forward<F>(chunk), threads);
+    }
+
+    // One explicit Euler step of y' = f(t, y, i).
+    template <state_range R, typename T, typename F> requires is_quantity_v<T>
+    void euler(R&& ys, T t, T dt, F&& f, size_t threads = 0) {
+        using X = std::ranges::range_value_t<R>;
+        using D = derivative_t<X, T>;
+        X* y = std::ranges::data(ys);
+        const auto h = dt.value;
+        for_chunks(std::ranges::size(ys), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) y[i] = X(y[i].value + h * derivative_value<D>(f(t, y[i], i)));
+        });
+    }
+
+    // One classic fourth-order Runge-Kutta step of y' = f(t, y, i).
+    template <state_range R, typename T, typename F> requires is_quantity_v<T>
+    void rk4(R&& ys, T t, T dt, F&& f, size_t threads = 0) {
+        using X = std::ranges::range_value_t<R>;
+        using D = derivative_t<X, T>;
+        X* y = std::ranges::data(ys);
+        const auto h = dt.value;
+        const T mid(t.value + h / 2), next(t.value + h);
+        for_chunks(std::ranges::size(ys), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto y0 = y[i].value;
+                const auto k1 = derivative_value<D>(f(t, y[i], i));
+                const auto k2 = derivative_value<D>(f(mid, X(y0 + h / 2 * k1), i));
+                const auto k3 = derivative_value<D>(f(mid, X(y0 + h / 2 * k2), i));
+                const auto k4 = derivative_value<D>(f(next, X(y0 + h * k3), i));
+                y[i] = X(y0 + h / 6 * (k1 + 2 * k2 + 2 * k3 + k4));
+            }
+        });
+    }
+
+    // One fourth-order Runge-Kutta step of x'' = a(t, x, v, i), with v = x'.
+    template <state_range RX, state_range RV, typename T, typename F> requires is_quantity_v<T>
+    void rk4(RX&& xs, RV&& vs, T t, T dt, F&& a, size_t threads = 0) {
+        using X = std::ranges::range_value_t<RX>;
+        using V = std::ranges::range_value_t<RV>;
+        using A = derivative_t<V, T>;
+        static_assert(std::is_same_v<pure_unit_t<typename V::u>, pure_unit_t<typename derivative_t<X, T>::u>>,
+                      "Velocities must have the unit of the positions over time.");
+        constexpr auto v_scale = conversion_factor<typename V::value_type, typename V::u,
+            typename derivative_t<X, T>::u>();
+        X* x = std::ranges::data(xs);
+        V* v = std::ranges::data(vs);
+        const auto h = dt.value;
+        const T mid(t.value + h / 2), next(t.value + h);
+        for_chunks(std::ranges::size(xs), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto x0 = x[i].value, v0 = v[i].value;
+                const auto a1 = derivative_value<A>(a(t, x[i], v[i], i));
+                const auto v1 = v0 + h / 2 * a1;
+                const auto a2 = derivative_value<A>(a(mid, X(x0 + h / 2 * v0 * v_scale), V(v1), i));
+                const auto v2 = v0 + h / 2 * a2;
+                const auto a3 = derivative_value<A>(a(mid, X(x0 + h / 2 * v1 * v_scale), V(v2), i));
+                const auto v3 = v0 + h * a3;
+                const auto a4 = derivative_value<A>(a(next, X(x0 + h * v2 * v_scale), V(v3), i));
+                x[i] = X(x0 + h / 6 * (v0 + 2 * v1 + 2 * v2 + v3) * v_scale);
+                v[i] = V(v0 + h / 6 * (a1 + 2 * a2 + 2 * a3 + a4));
+            }
+        });
+    }
+
+    // Semi-implicit (symplectic) Euler step of x'' = a(t, x, v, i): the velocity is updated first and the
+    // position moves with the new velocity.
+    template <state_range RX, state_range RV, typename T, typename F> requires is_quantity_v<T>
+    void semi_implicit_euler(RX&& xs, RV&& vs, T t, T dt, F&& a, size_t threads = 0) {
+        using X = std::ranges::range_value_t<RX>;
+        using V = std::ranges::range_value_t<RV>;
+        using A = derivative_t<V, T>;
+        static_assert(std::is_same_v<pure_unit_t<typename V::u>, pure_unit_t<typename derivative_t<X, T>::u>>,
+                      "Velocities must have the unit of the positions over time.");
+        constexpr auto v_scale = conversion_factor<typename V::value_type, typename V::u,
+            typename derivative_t<X, T>::u>();
+        X* x = std::ranges::data(xs);
+        V* v = std::ranges::data(vs);
+        const auto h = dt.value;
+        for_chunks(std::ranges::size(xs), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto vn = v[i].value + h * derivative_value<A>(a(t, x[i], v[i], i));
+                v[i] = V(vn);
+                x[i] = X(x[i].value + h * vn * v_scale);
+            }
+        });
+    }
+
+    // as[i] = a(t, xs[i], i); fills the accelerations verlet expects before its first step.
+    template <state_range RX, state_range RA, typename T, typename F> requires is_quantity_v<T>
+    void accelerations(const RX& xs, RA&& as, T t, F&& a, size_t threads = 0) {
+        using A = std::ranges::range_value_t<RA>;
+        const auto* x = std::ranges::data(xs);
+        A* acc = std::ranges::data(as);
+        for_chunks(std::ranges::size(xs), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) acc[i] = A(derivative_value<A>(a(t, x[i], i)));
+        });
+    }
+
+    // Velocity Verlet step of x'' = a(t, x, i) for position-only accelerations. as holds the accelerations at
+    // the current positions and is updated to the new ones, so a is evaluated once per step.
+    template <state_range RX, state_range RV, state_range RA, typename T, typename F> requires is_quantity_v<T>
+    void verlet(RX&& xs, RV&& vs, RA&& as, T t, T dt, F&& a, size_t threads = 0) {
+        using X = std::ranges::range_value_t<RX>;
+        using V = std::ranges::range_value_t<RV>;
+        using A = std::ranges::range_value_t<RA>;
+        static_assert(std::is_same_v<pure_unit_t<typename V::u>, pure_unit_t<typename derivative_t<X, T>::u>>,
+                      "Velocities must have the unit of the positions over time.");
+        static_assert(std::is_same_v<pure_unit_t<typename A::u>, pure_unit_t<typename derivative_t<V, T>::u>>,
+                      "Accelerations must have the unit of the velocities over time.");
+        constexpr auto v_scale = conversion_factor<typename V::value_type, typename V::u,
+            typename derivative_t<X, T>::u>();
+        constexpr auto a_scale = conversion_factor<typename A::value_type, typename A::u,
+            typename derivative_t<V, T>::u>();
+        X* x = std::ranges::data(xs);
+        V* v = std::ranges::data(vs);
+        A* acc = std::ranges::data(as);
+        const auto h = dt.value;
+        const T next(t.value + h);
+        for_chunks(std::ranges::size(xs), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto a0 = acc[i].value * a_scale;
+                const X xn(x[i].value + h * (v[i].value + h / 2 * a0) * v_scale);
+                const auto a1 = derivative_value<A>(a(next, xn, i));
+                x[i] = xn;
+                v[i] = V(v[i].value + h / 2 * (a0 + a1 * a_scale));
+                acc[i] = A(a1);
+            }
+        });
+    }
+
+    template <typename X, typename T>
+    struct AdaptiveOptions {
+        X absoluteTolerance;
+        float_t relativeTolerance = 1e-6;
+        T initialStep;
+        T minStep = T(0);
+        size_t maxSteps = size_t{1} << 20;
+    };
+
+    struct AdaptiveResult {
+        size_t steps = 0;
+        size_t rejected = 0;
+        // Elements that needed a step below minStep or more than maxSteps steps and were left where they stopped.
+        size_t failed = 0;
+    };
+
+    // Integrates y' = f(t, y, i) from t0 to t1 with the adaptive Dormand-Prince 5(4) method, every element with
+    // its own step sizes.
+    template <state_range R, typename T, typename F> requires is_quantity_v<T>
+    AdaptiveResult dormand_prince(R&& ys, T t0, T t1, F&& f,
+                                  const AdaptiveOptions<std::ranges::range_value_t<R>, T>& options,
+                                  size_t threads = 0) {
+        using X = std::ranges::range_value_t<R>;
+        using D = derivative_t<X, T>;
+        using V = typename X::value_type;
+        constexpr V a21 = V(1) / 5;
+        constexpr V a31 = V(3) / 40, a32 = V(9) / 40;
+        constexpr V a41 = V(44) / 45, a42 = V(-56) / 15, a43 = V(32) / 9;
+        constexpr V a51 = V(19372) / 6561, a52 = V(-25360) / 2187, a53 = V(64448) / 6561, a54 = V(-212) / 729;
+        constexpr V a61 = V(9017) / 3168, a62 = V(-355) / 33, a63 = V(46732) / 5247, a64 = V(49) / 176,
+                    a65 = V(-5103) / 18656;
+        constexpr V b1 = V(35) / 384, b3 = V(500) / 1113, b4 = V(125) / 192, b5 = V(-2187) / 6784, b6 = V(11) / 84;
+        constexpr V e1 = V(71) / 57600, e3 = V(-71) / 16695, e4 = V(71) / 1920, e5 = V(-17253) / 339200,
+                    e6 = V(22) / 525, e7 = V(-1) / 40;
+
+        X* y = std::ranges::data(ys);
+        const V end_time = t1.value;
+        const V atol = options.absoluteTolerance.value;
+        const V rtol = options.relativeTolerance;
+        auto partials = parallel_chunks(std::ranges::size(ys), threads, [&](size_t begin, size_t end) {
+            AdaptiveResult result;
+            for (size_t i = begin; i < end; ++i) {
+                V t = t0.value;
+                V h = options.initialStep.value;
+                V yi = y[i].value;
+                V k1 = derivative_value<D>(f(t0, y[i], i));
+                size_t steps = 0;
+                bool failed = false;
+                while (t < end_time) {
+                    if (++steps > options.maxSteps || h < options.minStep.value) {
+                        failed = true;
+                        break;
+                    }
+                    h = std::min(h, end_time - t);
+                    auto eval = [&](V dt, V yv) { return derivative_value<D>(f(T(t + dt), X(yv), i)); };
+                    V k2 = eval(h / 5, yi + h * (a21 * k1));
+                    V k3 = eval(h * 3 / 10, yi + h * (a31 * k1 + a32 * k2));
+                    V k4 = eval(h * 4 / 5, yi + h * (a41 * k1 + a42 * k2 + a43 * k3));
+                    V k5 = eval(h * 8 / 9, yi + h * (a51 * k1 + a52 * k2 + a53 * k3 + a54 * k4));
+                    V k6 = eval(h, yi + h * (a61 * k1 + a62 * k2 + a63 * k3 + a64 * k4 + a65 * k5));
+                    V y5 = yi + h * (b1 * k1 + b3 * k3 + b4 * k4 + b5 * k5 + b6 * k6);
+                    V k7 = eval(h, y5);
+                    V error = h * (e1 * k1 + e3 * k3 + e4 * k4 + e5 * k5 + e6 * k6 + e7 * k7);
+                    V scale = atol + rtol * std::max(std::abs(yi), std::abs(y5));
+                    V ratio = std::abs(error) / scale;
+                    // Step size controller with the usual safety factor and growth limits.
+                    V factor = ratio == 0 ? V(5) : std::clamp(V(0.9) * std::pow(ratio, V(-0.2)), V(0.2), V(5));
+                    if (ratio <= 1) {
+                        t += h;
+                        yi = y5;
+                        k1 = k7;
+                        ++result.steps;
+                    } else {
+                        ++result.rejected;
+                        factor = std::min(factor, V(1));
+                    }
+                    h *= factor;
+                }
+                y[i] = X(yi);
+                if (failed) ++result.failed;
+            }
+            return result;
+        });
+        AdaptiveResult total;
+        for (const auto& partial : partials) {
+            total.steps += partial.steps;
+            total.rejected += partial.rejected;
+            total.failed += partial.failed;
+        }
+        return total;
+    }
+}
@@ -0,0 +1,216 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Rect.hpp"
+
+// Region quadtree over Rect<T>. A rect is stored in the deepest node that fully contains it, rects
+// outside the root bounds stay at the root.
+template <typename T>
+struct Quadtree {
+    using Id = size_t;
+
+    explicit Quadtree(const Rect<T>& bounds, size_t nodeCapacity = 8, size_t maxDepth = 10)
+        : nodeCapacity(nodeCapacity), maxDepth(maxDepth) {
+        nodes.push_back(Node{bounds, 0, NoChild, {}});
+    }
+
+    Id insert(const Rect<T>& rect) {
+        Id id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+            items[id] = Item{rect, 0, true};
+        } else {
+            id = items.size();
+            items.push_back(Item{rect, 0, true});
+        }
+        place(id, 0);
+        ++count;
+        return id;
+    }
+
+    // Returns false, and changes nothing, if id is not alive.
+    bool remove(Id id) {
+        if (!alive(id)) return false;
+        detach(id);
+        items[id].alive = false;
+        freeIds.push_back(id);
+        --count;
+        return true;
+    }
+
+    bool move(Id id, const Rect<T>& rect) {
+        if (!alive(id)) return false;
+        auto& item = items[id];
+        const auto& node = nodes[item.node];
+        item.rect = rect;
+        if ((item.node == 0 || node.bounds.contains(rect)) && childFor(item.node, rect) == NoChild) return true;
+        detach(id);
+        place(id, 0);
+        return true;
+    }
+
+    void clear() {
+        Rect<T> bounds = nodes[0].bounds;
+        nodes.clear();
+        nodes.push_back(Node{bounds, 0, NoChild, {}});
+        items.clear();
+        freeIds.clear();
+        count = 0;
+    }
+
+    const Rect<T>& operator[](Id id) const {
+        return items[id].rect;
+    }
+
+    bool alive(Id id) const {
+        return id < items.size() && items[id].alive;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const Rect<T>& bounds() const {
+        return nodes[0].bounds;
+    }
+
+    template <typename F>
+    void queryPoint(const Vector2<T>& point, F&& f) const {
+        uint32_t index = 0;
+        while (true) {
+            const auto& node = nodes[index];
+            for (Id id : node.items) {
+                if (items[id].rect.contains(point)) f(id);
+            }
+            if (node.firstChild == NoChild) return;
+            uint32_t next = NoChild;
+            for (uint32_t c = 0; c < 4; ++c) {
+                if (nodes[node.firstChild + c].bounds.contains(point)) {
+                    next = node.firstChild + c;
+                    break;
+                }
+            }
+            if (next == NoChild) return;
+            index = next;
+        }
+    }
+
+    std::vector<Id> queryPoint(const Vector2<T>& point) const {
+        std::vector<Id> result;
+        queryPoint(point, [&](Id id) { result.push_back(id); });
+        return result;
+    }
+
+    template <typename F>
+    void queryRange(const Rect<T>& range, F&& f) const {
+        std::vector<uint32_t> stack;
+        stack.reserve(3 * maxDepth + 4);
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const auto& node = nodes[stack.back()];
+            stack.pop_back();
+            for (Id id : node.items) {
+                if (items[id].rect.mayIntersect(range)) f(id);
+            }
+            if (node.firstChild == NoChild) continue;
+            for (uint32_t c = 0; c < 4; ++c) {
+                if (nodes[node.firstChild + c].bounds.mayIntersect(range)) stack.push_back(node.firstChild + c);
+            }
+        }
+    }
+
+    std::vector<Id> queryRange(const Rect<T>& range) const {
+        std::vector<Id> result;
+        queryRange(range, [&](Id id) { result.push_back(id); });
+        return result;
+    }
+
+private:
+    static constexpr uint32_t NoChild = UINT32_MAX;
+
+    struct Node {
+        Rect<T> bounds;
+        uint32_t depth;
+        uint32_t firstChild;
+        std::vector<Id> items;
+    };
+
+    struct Item {
+        Rect<T> rect;
+        uint32_t node;
+        bool alive;
+    };
+
+    size_t nodeCapacity;
+    size_t maxDepth;
+    std::vector<Node> nodes;
+    std::vector<Item> items;
+    std::vector<Id> freeIds;
+    size_t count = 0;
+
+    uint32_t childFor(uint32_t index, const Rect<T>& rect) const {
+        const auto& node = nodes[index];
+        if (node.firstChild == NoChild) return NoChild;
+        for (uint32_t c = 0; c < 4; ++c) {
+            if (nodes[node.firstChild + c].bounds.contains(rect)) return node.firstChild + c;
+        }
+        return NoChild;
+    }
+
+    void place(Id id, uint32_t index) {
+        const auto& rect = items[id].rect;
+        for (uint32_t child = childFor(index, rect); child != NoChild; child = childFor(index, rect)) {
+            index = child;
+        }
+        items[id].node = index;
+        nodes[index].items.push_back(id);
+        if (nodes[index].items.size() > nodeCapacity && nodes[index].firstChild == NoChild &&
+            nodes[index].depth < maxDepth) {
+            split(index);
+        }
+    }
+
+    void split(uint32_t index) {
+        auto b = nodes[index].bounds;
+        auto depth = nodes[index].depth + 1;
+        T halfW = b.width / 2;
+        T halfH = b.height / 2;
+        auto first = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{Rect<T>(b.x, b.y, halfW, halfH), depth, NoChild, {}});
+        nodes.push_back(Node{Rect<T>(b.x + halfW, b.y, b.width - halfW, halfH), depth, NoChild, {}});
+        nodes.push_back(Node{Rect<T>(b.x, b.y + halfH, halfW, b.height - halfH), depth, NoChild, {}});
+        nodes.push_back(Node{Rect<T>(b.x + halfW, b.y + halfH, b.width - halfW, b.height - halfH), depth, NoChild, {}});
+        nodes[index].firstChild = first;
+
+        auto pending = std::move(nodes[index].items);
+        nodes[index].items.clear();
+        for (Id id : pending) {
+            uint32_t child = childFor(index, items[id].rect);
+            if (child == NoChild) {
+                nodes[index].items.push_back(id);
+            } else {
+                place(id, child);
+            }
+        }
+    }
+
+    void detach(Id id) {
+        auto& ids = nodes[items[id].node].items;
+        auto pos = std::find(ids.begin(), ids.end(), id);
+        *pos = ids.back();
+        ids.pop_back();
+    }
+};
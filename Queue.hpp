@@ -0,0 +1,203 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "Unit.hpp"
+
+// Bounded lock-free ring buffers of quantities. The unit lives in the type, so the slots hold raw values only.
+// Batches move the shared head or tail once per call, and popping into a range of another unit of the same dimension
+// converts on the way out with the compile-time factor. Capacities are rounded up to a power of two.
+namespace Unit {
+    // Converts the n raw values of Q at src into dst, which holds quantities of Q's dimension.
+    template <typename Q, typename Out>
+    void dequeue_values(const typename Q::value_type* src, size_t n, Out* dst) {
+        if constexpr (std::is_same_v<Out, Q>) {
+            for (size_t i = 0; i < n; ++i) dst[i] = Q(src[i]);
+        } else {
+            static_assert(is_quantity_v<Out> && std::is_same_v<pure_unit_t<typename Out::u>, pure_unit_t<typename Q::u>>,
+                          "Queues can only be popped into quantities of the same dimension.");
+            for (size_t i = 0; i < n; ++i) dst[i] = Out(Q(src[i]));
+        }
+    }
+
+    // Single-producer single-consumer queue. Each side keeps a cached copy of the other side's index on its own
+    // cache line and only reloads it when the queue looks full (or empty), so an uncontended push or pop touches
+    // no shared line but the slots themselves.
+    template <typename Q>
+    struct SpscQueue {
+        static_assert(is_quantity_v<Q>, "SpscQueue requires a Quantity type.");
+        using value_type = typename Q::value_type;
+
+        explicit SpscQueue(size_t capacity)
+            : mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), slots(new value_type[mask + 1]) {
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+
+        // Approximate while the other side is running.
+        size_t size() const {
+            return producer.tail.load(std::memory_order_acquire) - consumer.head.load(std::memory_order_acquire);
+        }
+
+        bool push(const Q& q) {
+            return push(std::span<const Q>(&q, 1)) == 1;
+        }
+
+        // Pushes as many of qs as fit and returns how many were pushed.
+        size_t push(std::span<const Q> qs) {
+            const size_t tail = producer.tail.load(std::memory_order_relaxed);
+            size_t n = std::min(qs.size(), producer.cachedHead + capacity() - tail);
+            if (n < qs.size()) {
+                producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+                n = std::min(qs.size(), producer.cachedHead + capacity() - tail);
+            }
+            for (size_t i = 0; i < n; ++i) slots[(tail + i) & mask] = qs[i].value;
+            producer.tail.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        template <typename Out = Q> requires is_quantity_v<Out>
+        bool pop(Out& out) {
+            return popInto(&out, 1) == 1;
+        }
+
+        // Pops up to size(out) quantities, converted to the element type of out, and returns how many were popped.
+        template <std::ranges::contiguous_range R>
+        size_t pop(R&& out) {
+            return popInto(std::ranges::data(out), std::ranges::size(out));
+        }
+
+    private:
+        struct alignas(64) Producer {
+            std::atomic<size_t> tail{0};
+            size_t cachedHead = 0;
+        };
+
+        struct alignas(64) Consumer {
+            std::atomic<size_t> head{0};
+            size_t cachedTail = 0;
+        };
+
+        size_t mask;
+        std::unique_ptr<value_type[]> slots;
+        Producer producer;
+        Consumer consumer;
+
+        template <typename Out>
+        size_t popInto(Out* dst, size_t count) {
+            const size_t head = consumer.head.load(std::memory_order_relaxed);
+            size_t n = std::min(count, consumer.cachedTail - head);
+            if (n < count) {
+                consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+                n = std::min(count, consumer.cachedTail - head);
+            }
+            const size_t first = std::min(n, capacity() - (head & mask));
+            dequeue_values<Q>(slots.get() + (head & mask), first, dst);
+            dequeue_values<Q>(slots.get(), n - first, dst + first);
+            consumer.head.store(head + n, std::memory_order_release);
+            return n;
+        }
+    };
+
+    // Multi-producer single-consumer queue. Producers claim a run of slots with a CAS on the tail and then publish
+    // each slot through its sequence number; the consumer reads slots in order until it meets one that is not yet
+    // published, so a slow producer only delays the samples behind its own.
+    template <typename Q>
+    struct MpscQueue {
+        static_assert(is_quantity_v<Q>, "MpscQueue requires a Quantity type.");
+        using value_type = typename Q::value_type;
+
+        explicit MpscQueue(size_t capacity)
+            : mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), cells(new Cell[mask + 1]) {
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+
+        // Approximate while producers or the consumer are running.
+        size_t size() const {
+            return tail.load(std::memory_order_acquire) - consumer.head.load(std::memory_order_acquire);
+        }
+
+        bool push(const Q& q) {
+            return push(std::span<const Q>(&q, 1)) == 1;
+        }
+
+        // Pushes as many of qs as fit, as one contiguous run, and returns how many were pushed.
+        size_t push(std::span<const Q> qs) {
+            size_t pos = tail.load(std::memory_order_relaxed);
+            size_t n;
+            do {
+                const size_t free = consumer.head.load(std::memory_order_acquire) + capacity() - pos;
+                n = std::min(qs.size(), free);
+                if (n == 0) return 0;
+            } while (!tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed));
+            for (size_t i = 0; i < n; ++i) {
+                Cell& cell = cells[(pos + i) & mask];
+                cell.value = qs[i].value;
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+
+        template <typename Out = Q> requires is_quantity_v<Out>
+        bool pop(Out& out) {
+            return popInto(&out, 1) == 1;
+        }
+
+        // Pops up to size(out) published quantities, converted to the element type of out, and returns how many
+        // were popped.
+        template <std::ranges::contiguous_range R>
+        size_t pop(R&& out) {
+            return popInto(std::ranges::data(out), std::ranges::size(out));
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{0};
+            value_type value{};
+        };
+
+        struct alignas(64) Consumer {
+            std::atomic<size_t> head{0};
+        };
+
+        size_t mask;
+        std::unique_ptr<Cell[]> cells;
+        alignas(64) std::atomic<size_t> tail{0};
+        Consumer consumer;
+
+        template <typename Out>
+        size_t popInto(Out* dst, size_t count) {
+            const size_t head = consumer.head.load(std::memory_order_relaxed);
+            size_t n = 0;
+            for (; n < count; ++n) {
+                const Cell& cell = cells[(head + n) & mask];
+                if (cell.sequence.load(std::memory_order_acquire) != head + n + 1) break;
+                dequeue_values<Q>(&cell.value, 1, dst + n);
+            }
+            consumer.head.store(head + n, std::memory_order_release);
+            return n;
+        }
+    };
+}
@@ -0,0 +1,89 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "Atomic.hpp"
+#include "Unit.hpp"
+
+namespace Unit {
+    // Throughput of a stream of Q, bytes by default, or of events counted in a unit of their own. record() adds to
+    // a per-thread shard of an integer total, a relaxed atomic add. update() is meant to be called periodically by a
+    // reporting thread: it folds the amount recorded since the previous update into an exponentially-decayed rate
+    // with time constant `window`, weighting every interval by its length, so irregular update periods are fine.
+    template <typename Q = defaults::byte>
+    struct RateMeter {
+        using count_type = Quantity<typename Q::u, uint64_t>;
+        using rate_type = with_value_t<decltype(Q{} / defaults::s{}), float_t>;
+        using time_type = decltype(extra_functions::get_time_ns());
+
+        explicit RateMeter(defaults::s window = defaults::s(5), size_t shardCount = std::thread::hardware_concurrency())
+            : window(window), counter(shardCount), lastTime(extra_functions::get_time_ns()) {
+        }
+
+        void record(uint64_t n = 1) {
+            counter.add(count_type(n));
+        }
+
+        // Amounts in another unit of the same dimension, e.g. kibi<byte>, are converted to whole Q first.
+        template <typename U, typename V>
+        void record(const Quantity<U, V>& amount) {
+            counter.add(count_type{amount});
+        }
+
+        count_type total() const {
+            return counter.load();
+        }
+
+        // Folds everything recorded since the previous update into the rate and returns it. The first update sets
+        // the rate to the average since construction.
+        rate_type update(time_type now = extra_functions::get_time_ns()) {
+            std::lock_guard lock(mutex);
+            const uint64_t current = counter.load().value;
+            const float_t dt = static_cast<float_t>((now - lastTime).value) * 1e-9;
+            if (dt <= 0) return rate();
+            const float_t instant = static_cast<float_t>(current - lastTotal) / dt;
+            float_t r = rateValue.load(std::memory_order_relaxed);
+            r = primed ? r + (1 - std::exp(-dt / window.value)) * (instant - r) : instant;
+            rateValue.store(r, std::memory_order_relaxed);
+            primed = true;
+            lastTotal = current;
+            lastTime = now;
+            return rate_type(r);
+        }
+
+        // The rate as of the last update.
+        rate_type rate() const {
+            return rate_type(rateValue.load(std::memory_order_relaxed));
+        }
+
+        // The rate in another unit, e.g. rate<mebi<Bps>>().
+        template <typename R>
+        R rate() const {
+            return R{rate()};
+        }
+
+    private:
+        defaults::s window;
+        ShardedQuantity<typename Q::u, uint64_t> counter;
+        std::atomic<float_t> rateValue{0};
+
+        std::mutex mutex;
+        bool primed = false;
+        uint64_t lastTotal = 0;
+        time_type lastTime;
+    };
+}
@@ -29,7 +29,7 @@ struct Rect {
     }
 
     constexpr Rect(const Vector2<T>& position, const Vector2<T>& size)
-        : x(position.x()), y(position.y()), width(size.x()), height(size.y()) {
+        : x(position.x), y(position.y), width(size.x), height(size.y) {
     }
 
     constexpr Vector2<T> position() const {
@@ -61,25 +61,48 @@ struct Rect {
     }
 
     constexpr void setPosition(const Vector2<T>& pos) {
-        x = pos.x();
-        y = pos.y();
+        x = pos.x;
+        y = pos.y;
     }
 
     constexpr void setSize(const Vector2<T>& size) {
-        width  = size.x();
-        height = size.y();
+        width  = size.x;
+        height = size.y;
     }
 
     constexpr bool contains(const Vector2<T>& point) const {
-        return point.x() >= x && point.x() < (x + width) &&
-            point.y() >= y && point.y() < (y + height);
+        return point.x >= x && point.x < (x + width) &&
+            point.y >= y && point.y < (y + height);
+    }
+
+    constexpr bool contains(const Rect& other) const {
+        return other.x >= x && other.x + other.width <= x + width &&
+            other.y >= y && other.y + other.height <= y + height;
+    }
+
+    // For bounded coordinates (e.g. Interval) a Unit::Certainty, since the rects may overlap for only some of the
+    // values within the bounds.
+    constexpr auto intersects(const Rect& other) const {
+        if constexpr (Unit::is_bounded_value_v<T>) {
+            if (x < other.x + other.width && x + width > other.x && y < other.y + other.height &&
+                y + height > other.y)
+                return Unit::Certainty::Definitely;
+            if (x >= other.x + other.width || x + width <= other.x || y >= other.y + other.height ||
+                y + height <= other.y)
+                return Unit::Certainty::Never;
+            return Unit::Certainty::Maybe;
+        } else {
+            return x < other.x + other.width &&
+                x + width > other.x &&
+                y < other.y + other.height &&
+                y + height > other.y;
+        }
     }
 
-    constexpr bool intersects(const Rect& other) const {
-        return x < other.x + other.width &&
-            x + width > other.x &&
-            y < other.y + other.height &&
-            y + height > other.y;
+    // Whether the rects can overlap, counting a Maybe as a hit, for spatial queries that must not miss anything.
+    constexpr bool mayIntersect(const Rect& other) const {
+        if constexpr (Unit::is_bounded_value_v<T>) return intersects(other) != Unit::Certainty::Never;
+        else return intersects(other);
     }
 
     constexpr Rect intersection(const Rect& other) const {
@@ -91,7 +114,7 @@ struct Rect {
         if (newRight > newX && newBottom > newY) {
             return Rect(newX, newY, newRight - newX, newBottom - newY);
         }
-        return Rect(0, 0, 0, 0);
+        return Rect();
     }
 
     constexpr bool operator==(const Rect&) const = default;
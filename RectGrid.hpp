@@ -0,0 +1,176 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Rect.hpp"
+
+// Uniform hash grid over Rect<T>. Every rect is registered in each cell it overlaps, so the cell size
+// should be close to the typical rect size.
+template <typename T>
+struct RectGrid {
+    using Id = size_t;
+
+    explicit RectGrid(T cellSize) : cellSize(cellSize) {
+    }
+
+    Id insert(const Rect<T>& rect) {
+        Id id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+            slots[id] = Slot{rect, true};
+        } else {
+            id = slots.size();
+            slots.push_back(Slot{rect, true});
+        }
+        addToCells(id, cellRange(rect));
+        ++count;
+        return id;
+    }
+
+    // Returns false, and changes nothing, if id is not alive.
+    bool remove(Id id) {
+        if (!alive(id)) return false;
+        removeFromCells(id, cellRange(slots[id].rect));
+        slots[id].alive = false;
+        freeIds.push_back(id);
+        --count;
+        return true;
+    }
+
+    bool move(Id id, const Rect<T>& rect) {
+        if (!alive(id)) return false;
+        auto oldRange = cellRange(slots[id].rect);
+        auto newRange = cellRange(rect);
+        slots[id].rect = rect;
+        if (oldRange == newRange) return true;
+        removeFromCells(id, oldRange);
+        addToCells(id, newRange);
+        return true;
+    }
+
+    void clear() {
+        cells.clear();
+        slots.clear();
+        freeIds.clear();
+        count = 0;
+    }
+
+    const Rect<T>& operator[](Id id) const {
+        return slots[id].rect;
+    }
+
+    bool alive(Id id) const {
+        return id < slots.size() && slots[id].alive;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    template <typename F>
+    void queryPoint(const Vector2<T>& point, F&& f) const {
+        auto it = cells.find(cellKey(cellOf(point.x), cellOf(point.y)));
+        if (it == cells.end()) return;
+        for (Id id : it->second) {
+            if (slots[id].rect.contains(point)) f(id);
+        }
+    }
+
+    std::vector<Id> queryPoint(const Vector2<T>& point) const {
+        std::vector<Id> result;
+        queryPoint(point, [&](Id id) { result.push_back(id); });
+        return result;
+    }
+
+    template <typename F>
+    void queryRange(const Rect<T>& range, F&& f) const {
+        auto r = cellRange(range);
+        for (int64_t cy = r.y0; cy <= r.y1; ++cy) {
+            for (int64_t cx = r.x0; cx <= r.x1; ++cx) {
+                auto it = cells.find(cellKey(cx, cy));
+                if (it == cells.end()) continue;
+                for (Id id : it->second) {
+                    const auto& rect = slots[id].rect;
+                    if (!rect.mayIntersect(range)) continue;
+                    // A rect spanning several cells is only reported from the first cell shared with the range.
+                    auto own = cellRange(rect);
+                    if (cx == std::max(own.x0, r.x0) && cy == std::max(own.y0, r.y0)) f(id);
+                }
+            }
+        }
+    }
+
+    std::vector<Id> queryRange(const Rect<T>& range) const {
+        std::vector<Id> result;
+        queryRange(range, [&](Id id) { result.push_back(id); });
+        return result;
+    }
+
+private:
+    struct Slot {
+        Rect<T> rect;
+        bool alive;
+    };
+
+    struct CellRange {
+        int64_t x0, y0, x1, y1;
+
+        constexpr bool operator==(const CellRange&) const = default;
+    };
+
+    T cellSize;
+    std::unordered_map<uint64_t, std::vector<Id>> cells;
+    std::vector<Slot> slots;
+    std::vector<Id> freeIds;
+    size_t count = 0;
+
+    int64_t cellOf(const T& v) const {
+        return static_cast<int64_t>(std::floor(static_cast<double>(v / cellSize)));
+    }
+
+    CellRange cellRange(const Rect<T>& rect) const {
+        return {cellOf(rect.x), cellOf(rect.y), cellOf(rect.x + rect.width), cellOf(rect.y + rect.height)};
+    }
+
+    static uint64_t cellKey(int64_t cx, int64_t cy) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32 | static_cast<uint32_t>(cy);
+    }
+
+    void addToCells(Id id, const CellRange& r) {
+        for (int64_t cy = r.y0; cy <= r.y1; ++cy) {
+            for (int64_t cx = r.x0; cx <= r.x1; ++cx) {
+                cells[cellKey(cx, cy)].push_back(id);
+            }
+        }
+    }
+
+    void removeFromCells(Id id, const CellRange& r) {
+        for (int64_t cy = r.y0; cy <= r.y1; ++cy) {
+            for (int64_t cx = r.x0; cx <= r.x1; ++cx) {
+                auto it = cells.find(cellKey(cx, cy));
+                if (it == cells.end()) continue;
+                auto& ids = it->second;
+                auto pos = std::find(ids.begin(), ids.end(), id);
+                if (pos != ids.end()) {
+                    *pos = ids.back();
+                    ids.pop_back();
+                }
+                if (ids.empty()) cells.erase(it);
+            }
+        }
+    }
+};
@@ -0,0 +1,239 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Executor.hpp"
+#include "Rect.hpp"
+
+// Structure-of-arrays list of Rect<T>. The batch tests produce one bit per rect (64 rects per word); they
+// are written branch-free over 64-element blocks so that the compiler can vectorize the comparisons.
+template <typename T>
+struct RectList {
+    std::vector<T> x;
+    std::vector<T> y;
+    std::vector<T> width;
+    std::vector<T> height;
+
+    RectList() = default;
+
+    explicit RectList(std::span<const Rect<T>> rects) {
+        reserve(rects.size());
+        for (const auto& rect : rects) push_back(rect);
+    }
+
+    size_t size() const {
+        return x.size();
+    }
+
+    bool empty() const {
+        return x.empty();
+    }
+
+    static constexpr size_t maskWords(size_t n) {
+        return (n + 63) / 64;
+    }
+
+    void reserve(size_t n) {
+        x.reserve(n);
+        y.reserve(n);
+        width.reserve(n);
+        height.reserve(n);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        width.clear();
+        height.clear();
+    }
+
+    void push_back(const Rect<T>& rect) {
+        x.push_back(rect.x);
+        y.push_back(rect.y);
+        width.push_back(rect.width);
+        height.push_back(rect.height);
+    }
+
+    Rect<T> operator[](size_t i) const {
+        return Rect<T>(x[i], y[i], width[i], height[i]);
+    }
+
+    void set(size_t i, const Rect<T>& rect) {
+        x[i] = rect.x;
+        y[i] = rect.y;
+        width[i] = rect.width;
+        height[i] = rect.height;
+    }
+
+    // Same predicate as Rect::intersects.
+    void intersects(const Rect<T>& other, std::span<uint64_t> mask, size_t threads = 0) const {
+        const auto left = raw(other.x);
+        const auto top = raw(other.y);
+        const auto right = raw(other.x + other.width);
+        const auto bottom = raw(other.y + other.height);
+        const auto *xs = raw(x), *ys = raw(y), *ws = raw(width), *hs = raw(height);
+        forEachBlock(mask, threads, [&](size_t i) {
+            return (xs[i] < right) & (xs[i] + ws[i] > left) & (ys[i] < bottom) & (ys[i] + hs[i] > top);
+        });
+    }
+
+    std::vector<uint64_t> intersects(const Rect<T>& other, size_t threads = 0) const {
+        std::vector<uint64_t> mask(maskWords(size()));
+        intersects(other, mask, threads);
+        return mask;
+    }
+
+    // Same predicate as Rect::contains(point).
+    void contains(const Vector2<T>& point, std::span<uint64_t> mask, size_t threads = 0) const {
+        const auto px = raw(point.x);
+        const auto py = raw(point.y);
+        const auto *xs = raw(x), *ys = raw(y), *ws = raw(width), *hs = raw(height);
+        forEachBlock(mask, threads, [&](size_t i) {
+            return (px >= xs[i]) & (px < xs[i] + ws[i]) & (py >= ys[i]) & (py < ys[i] + hs[i]);
+        });
+    }
+
+    std::vector<uint64_t> contains(const Vector2<T>& point, size_t threads = 0) const {
+        std::vector<uint64_t> mask(maskWords(size()));
+        contains(point, mask, threads);
+        return mask;
+    }
+
+    // Same predicate as Rect::contains(rect).
+    void contains(const Rect<T>& other, std::span<uint64_t> mask, size_t threads = 0) const {
+        const auto left = raw(other.x);
+        const auto top = raw(other.y);
+        const auto right = raw(other.x + other.width);
+        const auto bottom = raw(other.y + other.height);
+        const auto *xs = raw(x), *ys = raw(y), *ws = raw(width), *hs = raw(height);
+        forEachBlock(mask, threads, [&](size_t i) {
+            return (left >= xs[i]) & (right <= xs[i] + ws[i]) & (top >= ys[i]) & (bottom <= ys[i] + hs[i]);
+        });
+    }
+
+    std::vector<uint64_t> contains(const Rect<T>& other, size_t threads = 0) const {
+        std::vector<uint64_t> mask(maskWords(size()));
+        contains(other, mask, threads);
+        return mask;
+    }
+
+    // Same as Rect::intersection for every rect; empty results become {0, 0, 0, 0}.
+    void intersection(const Rect<T>& other, RectList& out) const {
+        const size_t n = size();
+        out.x.resize(n);
+        out.y.resize(n);
+        out.width.resize(n);
+        out.height.resize(n);
+        const auto left = raw(other.x);
+        const auto top = raw(other.y);
+        const auto right = raw(other.x + other.width);
+        const auto bottom = raw(other.y + other.height);
+        const auto *xs = raw(x), *ys = raw(y), *ws = raw(width), *hs = raw(height);
+        auto *ox = raw(out.x), *oy = raw(out.y), *ow = raw(out.width), *oh = raw(out.height);
+        using V = std::remove_cvref_t<decltype(*xs)>;
+        for (size_t i = 0; i < n; ++i) {
+            V newX = xs[i] > left ? xs[i] : left;
+            V newY = ys[i] > top ? ys[i] : top;
+            V newRight = xs[i] + ws[i] < right ? xs[i] + ws[i] : right;
+            V newBottom = ys[i] + hs[i] < bottom ? ys[i] + hs[i] : bottom;
+            bool hit = (newRight > newX) & (newBottom > newY);
+            ox[i] = hit ? newX : V(0);
+            oy[i] = hit ? newY : V(0);
+            ow[i] = hit ? V(newRight - newX) : V(0);
+            oh[i] = hit ? V(newBottom - newY) : V(0);
+        }
+    }
+
+    RectList intersection(const Rect<T>& other) const {
+        RectList out;
+        intersection(other, out);
+        return out;
+    }
+
+    // Expands a mask into the indices of its set bits.
+    static void compact(std::span<const uint64_t> mask, std::vector<uint32_t>& indices) {
+        for (size_t w = 0; w < mask.size(); ++w) {
+            uint64_t bits = mask[w];
+            while (bits != 0) {
+                indices.push_back(static_cast<uint32_t>(w * 64 + std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    static std::vector<uint32_t> compact(std::span<const uint64_t> mask) {
+        std::vector<uint32_t> indices;
+        compact(mask, indices);
+        return indices;
+    }
+
+    static size_t count(std::span<const uint64_t> mask) {
+        size_t n = 0;
+        for (uint64_t bits : mask) n += std::popcount(bits);
+        return n;
+    }
+
+private:
+    // The kernels work on the stored values directly; the unit checks happen at the Rect<T> boundary.
+    static constexpr auto raw(const T& v) {
+        if constexpr (requires { v.value; }) return v.value;
+        else return v;
+    }
+
+    static auto* raw(std::vector<T>& v) {
+        static_assert(sizeof(T) == sizeof(raw(T{})), "RectList requires T to have the layout of its value.");
+        if constexpr (requires { v[0].value; }) return reinterpret_cast<decltype(v[0].value)*>(v.data());
+        else return v.data();
+    }
+
+    static const auto* raw(const std::vector<T>& v) {
+        if constexpr (requires { v[0].value; }) return reinterpret_cast<const decltype(v[0].value)*>(v.data());
+        else return v.data();
+    }
+
+    // Each block is first evaluated into 64 byte flags, a plain compare loop that vectorizes well, then
+    // packed eight flags at a time with a multiply on little-endian targets. Large lists are split by mask word
+    // across `threads` threads (0: all of them).
+    template <typename F>
+    void forEachBlock(std::span<uint64_t> mask, size_t threads, F&& test) const {
+        const size_t n = size();
+        Unit::parallel_for(maskWords(n), [&](size_t firstWord, size_t lastWord) {
+            for (size_t w = firstWord; w < lastWord; ++w) {
+                const size_t base = w * 64;
+                const size_t len = std::min<size_t>(64, n - base);
+                alignas(64) uint8_t flags[64] = {};
+                if (len == 64) {
+                    for (size_t j = 0; j < 64; ++j) flags[j] = test(base + j);
+                } else {
+                    for (size_t j = 0; j < len; ++j) flags[j] = test(base + j);
+                }
+                uint64_t bits = 0;
+                if constexpr (std::endian::native == std::endian::little) {
+                    for (size_t k = 0; k < 8; ++k) {
+                        uint64_t bytes;
+                        std::memcpy(&bytes, flags + k * 8, 8);
+                        bits |= (bytes * 0x0102040810204080ull >> 56) << (k * 8);
+                    }
+                } else {
+                    for (size_t j = 0; j < 64; ++j) bits |= uint64_t{flags[j]} << j;
+                }
+                mask[w] = bits;
+            }
+        }, threads, std::max<size_t>(Unit::default_pool().grain() / 64, 1));
+    }
+};
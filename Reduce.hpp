@@ -0,0 +1,203 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Executor.hpp"
+#include "Unit.hpp"
+
+namespace Unit {
+    template <typename R>
+    concept quantity_range = std::ranges::input_range<R> && is_quantity_v<std::ranges::range_value_t<R>>;
+
+    template <quantity_range R>
+    using range_quantity_t = std::ranges::range_value_t<R>;
+
+    // Kahan sum: `compensation` holds the rounding error of `sum` with the opposite sign. Exact value types have
+    // no rounding error and skip it. The compensation is optimized away under -ffast-math.
+    template <typename Acc>
+    struct compensated_sum {
+        Acc sum = Acc(0);
+        Acc compensation = Acc(0);
+
+        constexpr void add(Acc x) {
+            if constexpr (std::is_floating_point_v<Acc>) {
+                Acc y = x - compensation;
+                Acc t = sum + y;
+                compensation = (t - sum) - y;
+                sum = t;
+            } else {
+                sum += x;
+            }
+        }
+
+        // Adds the two sums with an error-free TwoSum, so merging partial sums loses nothing either.
+        constexpr void merge(const compensated_sum& other) {
+            if constexpr (std::is_floating_point_v<Acc>) {
+                Acc t = sum + other.sum;
+                Acc b = t - sum;
+                Acc error = (sum - (t - b)) + (other.sum - b);
+                compensation = compensation + other.compensation - error;
+                sum = t;
+            } else {
+                sum += other.sum;
+            }
+        }
+
+        constexpr Acc value() const {
+            return sum - compensation;
+        }
+    };
+
+    // Sums term(i) for i in [begin, end) in independent lanes. The lanes break the loop-carried dependency, which
+    // lets the compiler vectorize the loop without reassociating anything.
+    template <typename Acc, typename F>
+    constexpr compensated_sum<Acc> lane_sum(size_t begin, size_t end, F&& term) {
+        constexpr size_t Lanes = 8;
+        Acc sums[Lanes] = {};
+        Acc compensations[Lanes] = {};
+        size_t i = begin;
+        for (; i + Lanes <= end; i += Lanes) {
+            for (size_t j = 0; j < Lanes; ++j) {
+                if constexpr (std::is_floating_point_v<Acc>) {
+                    Acc y = term(i + j) - compensations[j];
+                    Acc t = sums[j] + y;
+                    compensations[j] = (t - sums[j]) - y;
+                    sums[j] = t;
+                } else {
+                    sums[j] += term(i + j);
+                }
+            }
+        }
+        compensated_sum<Acc> total{sums[0], compensations[0]};
+        for (size_t j = 1; j < Lanes; ++j) total.merge({sums[j], compensations[j]});
+        for (; i < end; ++i) total.add(term(i));
+        return total;
+    }
+
+    // Splits [0, n) into chunks of about default_pool().grain() elements, calls chunk(begin, end) on each on up
+    // to `threads` threads (0: all of them) and returns the partial results in chunk order. The chunks do not
+    // depend on the thread count, so neither does the result.
+    template <typename F>
+    auto parallel_chunks(size_t n, size_t threads, F&& chunk) {
+        using T = decltype(chunk(size_t{0}, size_t{0}));
+        const size_t chunks = std::max<size_t>(n / default_pool().grain(), 1);
+        std::vector<T> partials(chunks);
+        parallel_for(chunks, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) partials[c] = chunk(n * c / chunks, n * (c + 1) / chunks);
+        }, threads, 1);
+        return partials;
+    }
+
+    template <typename Acc, typename F>
+    compensated_sum<Acc> parallel_sum(size_t n, size_t threads, F&& term) {
+        // Large inputs are always summed in the same chunks, even on one thread, so the result does not depend on
+        // the thread count.
+        if (n < 2 * default_pool().grain()) return lane_sum<Acc>(0, n, term);
+        auto partials = parallel_chunks(n, threads, [&](size_t begin, size_t end) {
+            return lane_sum<Acc>(begin, end, term);
+        });
+        for (size_t t = 1; t < partials.size(); ++t) partials[0].merge(partials[t]);
+        return partials[0];
+    }
+
+    // Compensated sum in accumulator_t of the value type, so float and Half storage still accumulate in double.
+    // Contiguous ranges are summed in vectorizable lanes and split across `threads` threads (0: all of them) when
+    // large.
+    template <quantity_range R>
+    constexpr auto sum(const R& values, size_t threads = 0) {
+        using Q = range_quantity_t<R>;
+        using Acc = accumulator_t<typename Q::value_type>;
+        compensated_sum<Acc> total;
+        if constexpr (std::ranges::contiguous_range<R>) {
+            const Q* data = std::ranges::data(values);
+            auto term = [data](size_t i) { return static_cast<Acc>(data[i].value); };
+            size_t n = std::ranges::size(values);
+            if (std::is_constant_evaluated()) total = lane_sum<Acc>(0, n, term);
+            else total = parallel_sum<Acc>(n, threads, term);
+        } else {
+            for (const auto& q : values) total.add(static_cast<Acc>(q.value));
+        }
+        return Quantity<typename Q::u, Acc>(total.value());
+    }
+
+    template <quantity_range R>
+    constexpr auto mean(const R& values, size_t threads = 0) {
+        using Q = range_quantity_t<R>;
+        using Acc = accumulator_t<typename Q::value_type>;
+        Acc total;
+        size_t n = 0;
+        if constexpr (std::ranges::sized_range<R>) {
+            total = sum(values, threads).value;
+            n = std::ranges::size(values);
+        } else {
+            compensated_sum<Acc> acc;
+            for (const auto& q : values) {
+                acc.add(static_cast<Acc>(q.value));
+                ++n;
+            }
+            total = acc.value();
+        }
+        return Quantity<typename Q::u, Acc>(n == 0 ? Acc(0) : total / static_cast<Acc>(n));
+    }
+
+    // Sum of a[i] * b[i] in the product unit, e.g. N and m spans give a N*m quantity that converts to J. Both
+    // ranges are contiguous and b holds at least as many elements as a.
+    template <std::ranges::contiguous_range A, std::ranges::contiguous_range B>
+        requires is_quantity_v<std::ranges::range_value_t<A>> || is_quantity_v<std::ranges::range_value_t<B>>
+    auto dot(const A& a, const B& b, size_t threads = 0) {
+        using QA = std::ranges::range_value_t<A>;
+        using QB = std::ranges::range_value_t<B>;
+        using P = decltype(std::declval<QA>() * std::declval<QB>());
+        constexpr auto raw = [](const auto& v) {
+            if constexpr (is_quantity_v<std::remove_cvref_t<decltype(v)>>) return v.value;
+            else return v;
+        };
+        using Acc = accumulator_t<std::remove_cvref_t<decltype(raw(std::declval<P>()))>>;
+        const QA* as = std::ranges::data(a);
+        const QB* bs = std::ranges::data(b);
+        auto total = parallel_sum<Acc>(std::ranges::size(a), threads, [=](size_t i) {
+            return static_cast<Acc>(raw(as[i])) * static_cast<Acc>(raw(bs[i]));
+        });
+        if constexpr (is_quantity_v<P>) return with_value_t<P, Acc>(total.value());
+        else return total.value();
+    }
+
+    // Folds the range with op, which must be associative. Large contiguous ranges are folded in chunks on separate
+    // threads, each seeded with its first element, and the chunk results are then folded into init in order. That
+    // needs T to be a quantity the elements convert to and op to fold two T's, as for a sum into another unit;
+    // other folds, such as a count, always run serially.
+    template <quantity_range R, typename T, typename Op>
+    T reduce(const R& values, T init, Op op, size_t threads = 0) {
+        using Q = range_quantity_t<R>;
+        if constexpr (std::ranges::contiguous_range<R> && is_quantity_v<T> && std::is_constructible_v<T, const Q&> &&
+            std::is_invocable_r_v<T, Op&, T, T>) {
+            const Q* data = std::ranges::data(values);
+            size_t n = std::ranges::size(values);
+            if (threads != 1 && n >= 2 * default_pool().grain()) {
+                auto partials = parallel_chunks(n, threads, [&](size_t begin, size_t end) {
+                    T acc = T(data[begin]);
+                    for (size_t i = begin + 1; i < end; ++i) acc = op(std::move(acc), data[i]);
+                    return acc;
+                });
+                for (auto& partial : partials) init = op(std::move(init), std::move(partial));
+                return init;
+            }
+        }
+        for (const auto& q : values) init = op(std::move(init), q);
+        return init;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <iostream>
+#include <type_traits>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // A Source quantity read as Target. The value stays as it was stored in Source; converting the view to other
+    // units only changes Target, so a chain of conversions composes into one factor at compile time and costs a
+    // single multiply (or none, if the chain returns to Source) when the value is read, without the rounding of
+    // every intermediate step.
+    template <typename Target, typename Source>
+    struct ScaledView {
+        static_assert(is_quantity_v<Target> && is_quantity_v<Source>, "ScaledView requires Quantity types.");
+        static_assert(std::is_same_v<pure_unit_t<typename Target::u>, pure_unit_t<typename Source::u>>,
+                      "ScaledView requires quantities of the same dimension.");
+
+        using target_type = Target;
+        using source_type = Source;
+
+        Source raw;
+
+        constexpr ScaledView() = default;
+
+        constexpr explicit ScaledView(const Source& source) : raw(source) {
+        }
+
+        // The same value read as Q, without touching it.
+        template <typename Q>
+        constexpr ScaledView<Q, Source> to() const {
+            return ScaledView<Q, Source>(raw);
+        }
+
+        constexpr const Source& source() const {
+            return raw;
+        }
+
+        constexpr Target get() const {
+            return Target{raw};
+        }
+
+        // ReSharper disable once CppNonExplicitConversionOperator
+        constexpr operator Target() const {
+            return get();
+        }
+
+        // Stored straight into any quantity of the same dimension, converting from Source once.
+        template <typename U, typename V>
+            requires (!std::is_same_v<Quantity<U, V>, Target> && std::is_same_v<pure_unit_t<U>,
+                                                                                    pure_unit_t<typename Source::u>>)
+        constexpr explicit operator Quantity<U, V>() const {
+            return Quantity<U, V>{raw};
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const ScaledView& v) {
+            return os << v.get();
+        }
+    };
+
+    // q as a view that defers every unit conversion until it is read.
+    template <typename Q> requires is_quantity_v<Q>
+    constexpr ScaledView<Q, Q> view(const Q& q) {
+        return ScaledView<Q, Q>(q);
+    }
+}
@@ -0,0 +1,332 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // Floating-point type the statistics of Q are computed in: accumulator_t of its value type, or float_t for
+    // integer and fixed-point storage.
+    template <typename Q>
+    using stats_value_t = std::conditional_t<std::is_floating_point_v<accumulator_t<typename Q::value_type>>,
+                                             accumulator_t<typename Q::value_type>, float_t>;
+
+    // Streaming count, mean, variance, min and max of a quantity (Welford). Each thread should update its own
+    // Stats and merge them when reading; merge is exact up to rounding (Chan et al.).
+    template <typename Q>
+    struct Stats {
+        static_assert(is_quantity_v<Q>, "Stats requires a Quantity type.");
+
+        using value_type = stats_value_t<Q>;
+        using quantity_type = Quantity<typename Q::u, value_type>;
+        using variance_type = decltype(quantity_type{} * quantity_type{});
+
+        constexpr void add(const Q& q) {
+            value_type x = static_cast<value_type>(q.value);
+            ++n;
+            value_type delta = x - meanValue;
+            meanValue += delta / static_cast<value_type>(n);
+            m2 += delta * (x - meanValue);
+            minValue = std::min(minValue, x);
+            maxValue = std::max(maxValue, x);
+        }
+
+        // Adds a range of quantities. Contiguous ranges are processed in blocks whose statistics are computed
+        // with plain loops and merged, which avoids the per-element division of add.
+        template <std::ranges::input_range R> requires std::is_same_v<std::ranges::range_value_t<R>, Q>
+        constexpr void add(const R& values) {
+            if constexpr (std::ranges::contiguous_range<R>) {
+                constexpr size_t Block = 1024;
+                const Q* data = std::ranges::data(values);
+                const size_t size = std::ranges::size(values);
+                for (size_t begin = 0; begin < size; begin += Block) {
+                    const size_t count = std::min(Block, size - begin);
+                    value_type sum = 0;
+                    value_type lo = std::numeric_limits<value_type>::infinity();
+                    value_type hi = -std::numeric_limits<value_type>::infinity();
+                    for (size_t i = 0; i < count; ++i) {
+                        value_type x = static_cast<value_type>(data[begin + i].value);
+                        sum += x;
+                        lo = std::min(lo, x);
+                        hi = std::max(hi, x);
+                    }
+                    Stats block;
+                    block.n = count;
+                    block.meanValue = sum / static_cast<value_type>(count);
+                    for (size_t i = 0; i < count; ++i) {
+                        value_type d = static_cast<value_type>(data[begin + i].value) - block.meanValue;
+                        block.m2 += d * d;
+                    }
+                    block.minValue = lo;
+                    block.maxValue = hi;
+                    merge(block);
+                }
+            } else {
+                for (const auto& q : values) add(q);
+            }
+        }
+
+        constexpr void merge(const Stats& other) {
+            if (other.n == 0) return;
+            if (n == 0) {
+                *this = other;
+                return;
+            }
+            const value_type na = static_cast<value_type>(n);
+            const value_type nb = static_cast<value_type>(other.n);
+            const value_type total = na + nb;
+            const value_type delta = other.meanValue - meanValue;
+            meanValue += delta * (nb / total);
+            m2 += other.m2 + delta * delta * (na * nb / total);
+            n += other.n;
+            minValue = std::min(minValue, other.minValue);
+            maxValue = std::max(maxValue, other.maxValue);
+        }
+
+        constexpr void reset() {
+            *this = Stats{};
+        }
+
+        constexpr size_t count() const {
+            return n;
+        }
+
+        constexpr quantity_type mean() const {
+            return quantity_type(meanValue);
+        }
+
+        // Population variance; sampleVariance divides by n - 1 instead.
+        constexpr variance_type variance() const {
+            return variance_type(n == 0 ? value_type(0) : m2 / static_cast<value_type>(n));
+        }
+
+        constexpr variance_type sampleVariance() const {
+            return variance_type(n < 2 ? value_type(0) : m2 / static_cast<value_type>(n - 1));
+        }
+
+        quantity_type stddev() const {
+            return quantity_type(std::sqrt(variance().value));
+        }
+
+        quantity_type sampleStddev() const {
+            return quantity_type(std::sqrt(sampleVariance().value));
+        }
+
+        // +inf and -inf while empty.
+        constexpr quantity_type min() const {
+            return quantity_type(minValue);
+        }
+
+        constexpr quantity_type max() const {
+            return quantity_type(maxValue);
+        }
+
+    private:
+        size_t n = 0;
+        value_type meanValue = 0;
+        value_type m2 = 0;
+        value_type minValue = std::numeric_limits<value_type>::infinity();
+        value_type maxValue = -std::numeric_limits<value_type>::infinity();
+    };
+
+    // Merging t-digest (Dunning) of a quantity: approximate quantiles in O(compression) memory, most accurate
+    // near the tails. Values are buffered and folded into the centroids in sorted batches. Like Stats, each
+    // thread should own a digest and the digests are merged when reading.
+    template <typename Q>
+    struct TDigest {
+        static_assert(is_quantity_v<Q>, "TDigest requires a Quantity type.");
+
+        using value_type = stats_value_t<Q>;
+        using quantity_type = Quantity<typename Q::u, value_type>;
+
+        struct Centroid {
+            value_type mean;
+            value_type weight;
+        };
+
+        explicit TDigest(value_type compression = 100) : compression(compression) {
+            bufferCapacity = static_cast<size_t>(compression) * 32;
+            buffer.reserve(bufferCapacity);
+        }
+
+        void add(const Q& q) {
+            value_type x = static_cast<value_type>(q.value);
+            buffer.push_back(x);
+            minValue = std::min(minValue, x);
+            maxValue = std::max(maxValue, x);
+            if (buffer.size() >= bufferCapacity) flush();
+        }
+
+        template <std::ranges::input_range R> requires std::is_same_v<std::ranges::range_value_t<R>, Q>
+        void add(const R& values) {
+            for (const auto& q : values) add(q);
+        }
+
+        void merge(const TDigest& other) {
+            std::vector<Centroid> merged(centroids.size() + other.centroids.size());
+            std::merge(centroids.begin(), centroids.end(), other.centroids.begin(), other.centroids.end(),
+                       merged.begin(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+            centroids = std::move(merged);
+            compressed = false;
+            buffer.insert(buffer.end(), other.buffer.begin(), other.buffer.end());
+            minValue = std::min(minValue, other.minValue);
+            maxValue = std::max(maxValue, other.maxValue);
+            flush();
+        }
+
+        // Folds the buffered values into the centroids; called automatically when the buffer fills up. Only the
+        // buffer is sorted, the centroids are kept in order and merged with it in a single pass.
+        void flush() {
+            if (buffer.empty() && (compressed || centroids.empty())) return;
+            if (!buffer.empty()) sortBuffer();
+
+            value_type total = static_cast<value_type>(buffer.size());
+            for (const auto& c : centroids) total += c.weight;
+            totalWeight = total;
+
+            std::vector<Centroid> out;
+            out.reserve(centroids.size() + 1);
+            size_t i = 0, j = 0;
+            auto next = [&] {
+                if (j == centroids.size() || (i < buffer.size() && buffer[i] < centroids[j].mean)) {
+                    return Centroid{buffer[i++], 1};
+                }
+                return centroids[j++];
+            };
+            // The current centroid's weighted sum is accumulated and divided once when it is emitted.
+            Centroid current = next();
+            value_type moment = current.mean * current.weight;
+            value_type before = 0;
+            value_type limit = total * quantileLimit(0);
+            while (i < buffer.size() || j < centroids.size()) {
+                Centroid c = next();
+                if (before + current.weight + c.weight <= limit) {
+                    current.weight += c.weight;
+                    moment += c.mean * c.weight;
+                } else {
+                    before += current.weight;
+                    out.push_back(Centroid{moment / current.weight, current.weight});
+                    limit = total * quantileLimit(before / total);
+                    current = c;
+                    moment = c.mean * c.weight;
+                }
+            }
+            out.push_back(Centroid{moment / current.weight, current.weight});
+            centroids = std::move(out);
+            buffer.clear();
+            compressed = true;
+        }
+
+        value_type count() {
+            flush();
+            return totalWeight;
+        }
+
+        // Interpolates between centroid centers, and towards the exact min and max at the ends. NaN while empty.
+        quantity_type quantile(value_type p) {
+            flush();
+            if (centroids.empty()) return quantity_type(std::numeric_limits<value_type>::quiet_NaN());
+            p = std::clamp<value_type>(p, 0, 1);
+            if (centroids.size() == 1) return quantity_type(std::lerp(minValue, maxValue, p));
+
+            const value_type target = p * totalWeight;
+            const Centroid& first = centroids.front();
+            if (target <= first.weight / 2) {
+                return quantity_type(std::lerp(minValue, first.mean, target / (first.weight / 2)));
+            }
+            value_type center = first.weight / 2;
+            for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+                value_type next = center + (centroids[i].weight + centroids[i + 1].weight) / 2;
+                if (target <= next) {
+                    return quantity_type(std::lerp(centroids[i].mean, centroids[i + 1].mean,
+                                                   (target - center) / (next - center)));
+                }
+                center = next;
+            }
+            const Centroid& last = centroids.back();
+            value_type t = std::min<value_type>((target - center) / (last.weight / 2), 1);
+            return quantity_type(std::lerp(last.mean, maxValue, t));
+        }
+
+        quantity_type min() const {
+            return quantity_type(minValue);
+        }
+
+        quantity_type max() const {
+            return quantity_type(maxValue);
+        }
+
+    private:
+        value_type compression;
+        size_t bufferCapacity;
+        value_type totalWeight = 0;
+        value_type minValue = std::numeric_limits<value_type>::infinity();
+        value_type maxValue = -std::numeric_limits<value_type>::infinity();
+        std::vector<Centroid> centroids;
+        std::vector<value_type> buffer;
+        std::vector<uint64_t> keys;
+        std::vector<uint64_t> scratch;
+        bool compressed = true;
+
+        // LSD radix sort of the buffer on its bit patterns, flipped so that unsigned order is floating-point order.
+        // Comparison sorts of random values spend most of their time on mispredicted branches.
+        void sortBuffer() {
+            if (buffer.size() < 2) return;
+            if constexpr (sizeof(value_type) != sizeof(uint64_t)) {
+                std::sort(buffer.begin(), buffer.end());
+            } else {
+                constexpr int Bits = 11;
+                constexpr int Passes = (64 + Bits - 1) / Bits;
+                constexpr size_t Buckets = size_t{1} << Bits;
+                const size_t n = buffer.size();
+                keys.resize(n);
+                scratch.resize(n);
+                std::vector<uint32_t> counts(Passes * Buckets);
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t bits = std::bit_cast<uint64_t>(buffer[i]);
+                    uint64_t key = bits ^ ((0 - (bits >> 63)) | (uint64_t{1} << 63));
+                    keys[i] = key;
+                    for (int p = 0; p < Passes; ++p) ++counts[p * Buckets + (key >> (p * Bits) & (Buckets - 1))];
+                }
+                for (int p = 0; p < Passes; ++p) {
+                    uint32_t* count = counts.data() + p * Buckets;
+                    // Digits shared by every key do not reorder anything.
+                    if (count[keys[0] >> (p * Bits) & (Buckets - 1)] == n) continue;
+                    uint32_t offset = 0;
+                    for (size_t b = 0; b < Buckets; ++b) offset += std::exchange(count[b], offset);
+                    for (size_t i = 0; i < n; ++i) scratch[count[keys[i] >> (p * Bits) & (Buckets - 1)]++] = keys[i];
+                    keys.swap(scratch);
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t key = keys[i];
+                    buffer[i] = std::bit_cast<value_type>(key ^ (((key >> 63) - 1) | (uint64_t{1} << 63)));
+                }
+            }
+        }
+
+        // Largest quantile a centroid starting at q may reach under the k1 scale function
+        // k(q) = compression / (2 pi) * asin(2q - 1), i.e. k^-1(k(q) + 1).
+        value_type quantileLimit(value_type q) const {
+            value_type k = std::asin(2 * q - 1) + 2 * pi / compression;
+            return k >= pi / 2 ? value_type(1) : (std::sin(k) + 1) / 2;
+        }
+    };
+}
@@ -0,0 +1,303 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <ranges>
+#include <utility>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // Accuracy of the batch trigonometry kernels:
+    //   Exact: the <cmath> functions per element, the same results as the scalar defaults::sin/cos/atan2.
+    //   Ulp:   polynomial kernels within 2.5 ulp on rad, and 2e-16 absolute on deg and grad.
+    //   Fast:  shorter polynomials with an absolute error below 2.5e-8.
+    enum class Accuracy {
+        Exact,
+        Ulp,
+        Fast
+    };
+
+    template <typename R>
+    concept angle_range = std::ranges::contiguous_range<R> &&
+        is_quantity_v<std::ranges::range_value_t<R>> &&
+        std::is_same_v<pure_unit_t<typename std::ranges::range_value_t<R>::u>, pure_unit_t<defaults::rad::u>>;
+
+    // Cody-Waite argument reduction done in the angle's own unit: k quarter turns are subtracted from the stored
+    // value and only the small remainder is scaled to radians, so deg inputs are never converted as a whole.
+    // The quarter turn is split in three parts whose first one has 33 significant bits, which keeps k * p1
+    // exact for |k| < 2^20.
+    template <typename U>
+    struct angle_reduction {
+        static constexpr float_t scale = get_unit_scale<U>();
+        static constexpr float_t quadrants = scale * (2 / pi);
+        static constexpr int32_t max_quadrant = 1 << 19;
+
+        // Exact for units defined through pi, e.g. 90 for deg.
+        static constexpr long double quarter = scale_as<long double>(ExactScale{1, 2, 1, true, 0.5L} / unit_scale_v<U>);
+        static constexpr float_t p1 = scale == 1 ? 1.57079632673412561417e+00 : std::bit_cast<float_t>(
+            std::bit_cast<uint64_t>(static_cast<float_t>(quarter)) & ~((uint64_t{1} << 20) - 1)
+        );
+        static constexpr float_t p2 = scale == 1
+            ? 6.07710050630396597660e-11
+            : static_cast<float_t>(quarter - p1);
+        static constexpr float_t p3 = scale == 1
+            ? 2.02226624879595063154e-21
+            : static_cast<float_t>(quarter - p1 - p2);
+    };
+
+    // sin(r) and cos(r) for |r| <= pi/4, with z = r * r. The Ulp coefficients are the fdlibm kernels.
+    template <Accuracy A>
+    constexpr float_t sin_poly(float_t r, float_t z) {
+        if constexpr (A == Accuracy::Fast) {
+            return r + r * z * (-1.0 / 6 + z * (1.0 / 120 + z * (-1.0 / 5040 + z * (1.0 / 362880))));
+        } else {
+            constexpr float_t S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03,
+                              S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06,
+                              S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+            return r + r * z * (S1 + z * (S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)))));
+        }
+    }
+
+    template <Accuracy A>
+    constexpr float_t cos_poly(float_t z) {
+        if constexpr (A == Accuracy::Fast) {
+            return 1 + z * (-0.5 + z * (1.0 / 24 + z * (-1.0 / 720 + z * (1.0 / 40320))));
+        } else {
+            constexpr float_t C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                              C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                              C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+            float_t r = z * z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+            float_t hz = 0.5 * z;
+            float_t w = 1 - hz;
+            return w + (((1 - w) - hz) + r);
+        }
+    }
+
+    // atan(t) for |t| <= 7/16.
+    template <Accuracy A>
+    constexpr float_t atan_poly(float_t t) {
+        float_t z = t * t;
+        if constexpr (A == Accuracy::Fast) {
+            return t - t * z * (1.0 / 3 + z * (-1.0 / 5 + z * (1.0 / 7 + z * (-1.0 / 9 + z * (1.0 / 11 +
+                z * (-1.0 / 13 + z * (1.0 / 15)))))));
+        } else {
+            constexpr float_t T0 = 3.33333333333329318027e-01, T1 = -1.99999999998764832476e-01,
+                              T2 = 1.42857142725034663711e-01, T3 = -1.11111104054623557880e-01,
+                              T4 = 9.09088713343650656196e-02, T5 = -7.69187620504482999495e-02,
+                              T6 = 6.66107313738753120669e-02, T7 = -5.83357013379057348645e-02,
+                              T8 = 4.97687799461593236017e-02, T9 = -3.65315727442169155270e-02,
+                              T10 = 1.62858201153657823623e-02;
+            float_t w = z * z;
+            float_t s1 = z * (T0 + w * (T2 + w * (T4 + w * (T6 + w * (T8 + w * T10)))));
+            float_t s2 = w * (T1 + w * (T3 + w * (T5 + w * (T7 + w * T9))));
+            return t - t * (s1 + s2);
+        }
+    }
+
+    // The main loop is branch-free so that it vectorizes; arguments beyond the reduction range (and inf/nan)
+    // are recomputed with std::sin/cos afterwards.
+    template <Accuracy A, typename U, typename Q, typename S, typename C>
+    void sincos_kernel(const Q* src, size_t n, S* sinOut, C* cosOut) {
+        using R = angle_reduction<U>;
+        if constexpr (A == Accuracy::Exact) {
+            for (size_t i = 0; i < n; ++i) {
+                float_t x = static_cast<float_t>(src[i].value) * R::scale;
+                if constexpr (!std::is_void_v<S>) sinOut[i] = static_cast<S>(std::sin(x));
+                if constexpr (!std::is_void_v<C>) cosOut[i] = static_cast<C>(std::cos(x));
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                float_t x = static_cast<float_t>(src[i].value);
+                // Clamped so that huge and infinite arguments convert to int32 without overflow; nan fails both
+                // comparisons and ends up at -bound. Their results are replaced below.
+                constexpr auto bound = static_cast<float_t>(R::max_quadrant);
+                float_t t = std::min(bound, std::max(-bound, x * R::quadrants));
+                auto k = static_cast<int32_t>(t + (t >= 0 ? 0.5 : -0.5));
+                auto kd = static_cast<float_t>(k);
+                float_t r = ((x - kd * R::p1) - kd * R::p2) - kd * R::p3;
+                if constexpr (R::scale != 1) r *= R::scale;
+                float_t z = r * r;
+                float_t s = sin_poly<A>(r, z);
+                float_t c = cos_poly<A>(z);
+                // Quadrant selection as exact multiplies by 0/1 and +-1, which vectorizes unlike selects on k.
+                auto swap = static_cast<float_t>(k & 1);
+                if constexpr (!std::is_void_v<S>) {
+                    float_t v = s * (1 - swap) + c * swap;
+                    sinOut[i] = static_cast<S>(v * static_cast<float_t>(1 - (k & 2)));
+                }
+                if constexpr (!std::is_void_v<C>) {
+                    float_t v = c * (1 - swap) + s * swap;
+                    cosOut[i] = static_cast<C>(v * static_cast<float_t>(1 - ((k + 1) & 2)));
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                float_t x = static_cast<float_t>(src[i].value);
+                if (std::abs(x * R::quadrants) < R::max_quadrant) continue;
+                if constexpr (!std::is_void_v<S>) sinOut[i] = static_cast<S>(std::sin(x * R::scale));
+                if constexpr (!std::is_void_v<C>) cosOut[i] = static_cast<C>(std::cos(x * R::scale));
+            }
+        }
+    }
+
+    // a where the sign bit of s is set, b elsewhere. Plain selects on computed values get turned back into
+    // branches by GCC, which then cannot vectorize them because the arms may trap.
+    constexpr float_t select_negative(float_t s, float_t a, float_t b) {
+        uint64_t mask = 0 - (std::bit_cast<uint64_t>(s) >> 63);
+        return std::bit_cast<float_t>((std::bit_cast<uint64_t>(a) & mask) | (std::bit_cast<uint64_t>(b) & ~mask));
+    }
+
+    template <typename V>
+    constexpr float_t raw_value(const V& v) {
+        if constexpr (is_quantity_v<V>) return static_cast<float_t>(v.value);
+        else return static_cast<float_t>(v);
+    }
+
+    // atan2(y, x) for finite arguments that are not both zero.
+    template <Accuracy A>
+    constexpr float_t atan2_poly(float_t y, float_t x) {
+        constexpr float_t atan_half_hi = 4.63647609000806093515e-01, atan_half_lo = 2.26987774529616870924e-17;
+        constexpr float_t pio4_hi = 7.85398163397448278999e-01, pio4_lo = 3.06161699786838301793e-17;
+        constexpr float_t pio2_hi = 1.57079632679489655800e+00, pio2_lo = 6.12323399573676603587e-17;
+        constexpr float_t pi_hi = 3.14159265358979311600e+00, pi_lo = 1.22464679914735317720e-16;
+
+        float_t ax = std::abs(x);
+        float_t ay = std::abs(y);
+        // min / max, written as selects so that constant arguments (atan passes x = 1) do not become branches.
+        float_t a = select_negative(ax - ay, ax, ay) / select_negative(ax - ay, ay, ax);
+        // Same ranges as fdlibm: atan(a) directly below 7/16, atan(1/2) + atan((2a - 1) / (2 + a)) below 11/16
+        // and pi/4 + atan((a - 1) / (a + 1)) above.
+        float_t mid = 0.4375 - a;
+        float_t high = 0.6875 - a;
+        float_t t = select_negative(high, (a - 1) / (a + 1), select_negative(mid, (2 * a - 1) / (2 + a), a));
+        float_t base_hi = select_negative(high, pio4_hi, select_negative(mid, atan_half_hi, 0));
+        float_t base_lo = select_negative(high, pio4_lo, select_negative(mid, atan_half_lo, 0));
+        float_t r = base_hi + (base_lo + atan_poly<A>(t));
+        r = select_negative(ax - ay, pio2_hi + (pio2_lo - r), r);
+        r = select_negative(x, pi_hi + (pi_lo - r), r);
+        return std::copysign(r, y);
+    }
+
+    // dst[i] = atan2(args(i)) where args returns a (y, x) pair. Infinities, nans and (0, 0) are recomputed with
+    // std::atan2 after the vectorized pass.
+    template <Accuracy A, typename OutQ, typename F>
+    void atan2_kernel(size_t n, OutQ* dst, F&& args) {
+        using Rad = defaults::rad;
+        if constexpr (A == Accuracy::Exact) {
+            for (size_t i = 0; i < n; ++i) {
+                auto [y, x] = args(i);
+                dst[i] = OutQ(Rad(std::atan2(y, x)));
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                auto [y, x] = args(i);
+                dst[i] = OutQ(Rad(atan2_poly<A>(y, x)));
+            }
+            for (size_t i = 0; i < n; ++i) {
+                auto [y, x] = args(i);
+                if (std::isfinite(x) && std::isfinite(y) && (x != 0 || y != 0)) continue;
+                dst[i] = OutQ(Rad(std::atan2(y, x)));
+            }
+        }
+    }
+
+    namespace math {
+        // Batch trigonometry over contiguous ranges of angles (rad, deg, grad, ...). The outputs are ranges of
+        // plain numbers and must hold at least as many elements as the input.
+        template <Accuracy A = Accuracy::Ulp, angle_range In, std::ranges::contiguous_range Out>
+        void sin(const In& angles, Out&& out) {
+            using Q = std::ranges::range_value_t<In>;
+            sincos_kernel<A, typename Q::u, Q, std::ranges::range_value_t<Out>, void>(
+                std::ranges::data(angles), std::ranges::size(angles), std::ranges::data(out), nullptr
+            );
+        }
+
+        template <Accuracy A = Accuracy::Ulp, angle_range In, std::ranges::contiguous_range Out>
+        void cos(const In& angles, Out&& out) {
+            using Q = std::ranges::range_value_t<In>;
+            sincos_kernel<A, typename Q::u, Q, void, std::ranges::range_value_t<Out>>(
+                std::ranges::data(angles), std::ranges::size(angles), nullptr, std::ranges::data(out)
+            );
+        }
+
+        template <Accuracy A = Accuracy::Ulp, angle_range In, std::ranges::contiguous_range SinOut,
+                  std::ranges::contiguous_range CosOut>
+        void sincos(const In& angles, SinOut&& sinOut, CosOut&& cosOut) {
+            using Q = std::ranges::range_value_t<In>;
+            using S = std::ranges::range_value_t<SinOut>;
+            using C = std::ranges::range_value_t<CosOut>;
+            sincos_kernel<A, typename Q::u, Q, S, C>(
+                std::ranges::data(angles), std::ranges::size(angles), std::ranges::data(sinOut),
+                std::ranges::data(cosOut)
+            );
+        }
+
+        // out[i] = atan2(ys[i], xs[i]) in the unit of the output range. ys and xs are plain numbers or
+        // quantities of the same dimension; the xs to ys unit factor is folded into a single multiply.
+        template <Accuracy A = Accuracy::Ulp, std::ranges::contiguous_range InY, std::ranges::contiguous_range InX,
+                  angle_range Out>
+        void atan2(const InY& ys, const InX& xs, Out&& out) {
+            using Y = std::ranges::range_value_t<InY>;
+            using X = std::ranges::range_value_t<InX>;
+
+            constexpr float_t x_scale = [] {
+                if constexpr (is_quantity_v<X> && is_quantity_v<Y>) {
+                    static_assert(std::is_same_v<pure_unit_t<typename X::u>, pure_unit_t<typename Y::u>>,
+                                  "atan2 requires both inputs to have the same dimension.");
+                    return conversion_factor<float_t, typename X::u, typename Y::u>();
+                } else {
+                    static_assert(!is_quantity_v<X> && !is_quantity_v<Y>,
+                                  "atan2 requires both inputs to be quantities or both to be plain numbers.");
+                    return float_t(1);
+                }
+            }();
+
+            const Y* ysData = std::ranges::data(ys);
+            const X* xsData = std::ranges::data(xs);
+            atan2_kernel<A>(std::ranges::size(ys), std::ranges::data(out), [&](size_t i) {
+                return std::pair{raw_value(ysData[i]), raw_value(xsData[i]) * x_scale};
+            });
+        }
+
+        // Batch asin, acos and atan of plain numbers into a range of angles. asin and acos go through
+        // atan2(x, sqrt(1 - x^2)), which keeps them within about 2 ulp; like math::sqrt they only vectorize with
+        // -fno-math-errno under GCC.
+        template <Accuracy A = Accuracy::Ulp, std::ranges::contiguous_range In, angle_range Out>
+        void asin(const In& values, Out&& out) {
+            const auto* src = std::ranges::data(values);
+            atan2_kernel<A>(std::ranges::size(values), std::ranges::data(out), [&](size_t i) {
+                float_t x = raw_value(src[i]);
+                return std::pair{x, std::sqrt((1 - x) * (1 + x))};
+            });
+        }
+
+        template <Accuracy A = Accuracy::Ulp, std::ranges::contiguous_range In, angle_range Out>
+        void acos(const In& values, Out&& out) {
+            const auto* src = std::ranges::data(values);
+            atan2_kernel<A>(std::ranges::size(values), std::ranges::data(out), [&](size_t i) {
+                float_t x = raw_value(src[i]);
+                return std::pair{std::sqrt((1 - x) * (1 + x)), x};
+            });
+        }
+
+        template <Accuracy A = Accuracy::Ulp, std::ranges::contiguous_range In, angle_range Out>
+        void atan(const In& values, Out&& out) {
+            const auto* src = std::ranges::data(values);
+            atan2_kernel<A>(std::ranges::size(values), std::ranges::data(out), [&](size_t i) {
+                return std::pair{raw_value(src[i]), float_t(1)};
+            });
+        }
+    }
+}
@@ -0,0 +1,466 @@
+/*
+* Unit.hpp
+ * A header-only C++20 library for compile-time dimensional analysis and unit conversion.
+ *
+ * Version: 0.20
+ * Author:  OguzhanUmutlu
+ * GitHub:  https://github.com/OguzhanUmutlu/unit.hpp
+ *
+ * Licensed under the MIT License.
+ */
+
+#pragma once
+#include <atomic>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "Unit.hpp"
+
+namespace Unit {
+    // Identifies an independent error source of correlated Uncertain values.
+    inline uint64_t new_uncertainty_source() {
+        static std::atomic<uint64_t> next{0};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Value x with a standard deviation, propagated to first order through every operation and math function:
+    // the uncertainty of f(a, b) is the root sum of squares of df/da * sigma(a) and df/db * sigma(b).
+    //
+    // By default the operands of every operation are assumed to be independent, so e.g. a - a has an uncertainty
+    // of sqrt(2) * sigma(a). With Correlated, every value instead keeps its sensitivity to each independent
+    // measurement it depends on, as a list sorted by source, and a - a is exact. The lists only hold the sources
+    // a value actually depends on, but they are heap-allocated.
+    //
+    // Comparisons only look at x. There is no conversion back to T, so uncertainties are never dropped silently.
+    template <typename T, bool Correlated = false>
+    struct Uncertain {
+        static_assert(std::is_floating_point_v<T>, "Uncertain requires a floating-point T.");
+
+        using scalar_type = T;
+        static constexpr bool correlated = Correlated;
+
+        struct Term {
+            uint64_t source;
+            T weight;
+        };
+
+        T x;
+        // The variance, or the weights of the sources whose root sum of squares is the standard deviation. Keeping
+        // the variance instead of the standard deviation spares a square root per operation.
+        std::conditional_t<Correlated, std::vector<Term>, T> error;
+
+        constexpr Uncertain() : x(0), error{} {
+        }
+
+        // Constants are exact.
+        template <typename V> requires std::is_arithmetic_v<V>
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr Uncertain(V v) : x(static_cast<T>(v)), error{} {
+        }
+
+        // A measurement; in the correlated mode it becomes a new independent source.
+        Uncertain(T x, T sigma) : x(x), error{} {
+            if constexpr (Correlated) {
+                if (sigma != 0) error.push_back(Term{new_uncertainty_source(), sigma});
+            } else {
+                error = sigma * sigma;
+            }
+        }
+
+        template <typename U>
+        constexpr explicit Uncertain(const Uncertain<U, Correlated>& other) : x(static_cast<T>(other.x)), error{} {
+            if constexpr (Correlated) {
+                for (const auto& term : other.error) error.push_back(Term{term.source, static_cast<T>(term.weight)});
+            } else {
+                error = static_cast<T>(other.error);
+            }
+        }
+
+        constexpr T sigma() const {
+            if constexpr (Correlated) {
+                T sum = 0;
+                for (const auto& term : error) sum += term.weight * term.weight;
+                return std::sqrt(sum);
+            } else {
+                return std::sqrt(error);
+            }
+        }
+
+        constexpr T variance() const {
+            if constexpr (Correlated) {
+                T sum = 0;
+                for (const auto& term : error) sum += term.weight * term.weight;
+                return sum;
+            } else {
+                return error;
+            }
+        }
+
+        // f(x) for a function f with f'(x) = slope.
+        constexpr Uncertain chain(T fx, T slope) const {
+            Uncertain r(fx);
+            if constexpr (Correlated) {
+                r.error = error;
+                for (auto& term : r.error) term.weight *= slope;
+            } else {
+                r.error = slope * slope * error;
+            }
+            return r;
+        }
+
+        // f(this, other) for a function f with partial derivatives a and b.
+        constexpr Uncertain chain(T fx, T a, const Uncertain& other, T b) const {
+            Uncertain r(fx);
+            if constexpr (Correlated) {
+                r.error.reserve(error.size() + other.error.size());
+                size_t i = 0, j = 0;
+                while (i < error.size() || j < other.error.size()) {
+                    if (j == other.error.size() || (i < error.size() && error[i].source < other.error[j].source)) {
+                        r.error.push_back(Term{error[i].source, a * error[i].weight});
+                        ++i;
+                    } else if (i == error.size() || other.error[j].source < error[i].source) {
+                        r.error.push_back(Term{other.error[j].source, b * other.error[j].weight});
+                        ++j;
+                    } else {
+                        r.error.push_back(Term{error[i].source, a * error[i].weight + b * other.error[j].weight});
+                        ++i;
+                        ++j;
+                    }
+                }
+            } else {
+                r.error = a * a * error + b * b * other.error;
+            }
+            return r;
+        }
+
+        constexpr Uncertain operator+(const Uncertain& rhs) const {
+            return chain(x + rhs.x, 1, rhs, 1);
+        }
+
+        constexpr Uncertain operator-(const Uncertain& rhs) const {
+            return chain(x - rhs.x, 1, rhs, -1);
+        }
+
+        constexpr Uncertain operator*(const Uncertain& rhs) const {
+            return chain(x * rhs.x, rhs.x, rhs, x);
+        }
+
+        constexpr Uncertain operator/(const Uncertain& rhs) const {
+            const T inv = 1 / rhs.x;
+            const T q = x * inv;
+            return chain(q, inv, rhs, -q * inv);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator+(const Uncertain& a, S b) {
+            Uncertain r = a;
+            r.x += static_cast<T>(b);
+            return r;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator+(S a, const Uncertain& b) {
+            return b + a;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator-(const Uncertain& a, S b) {
+            Uncertain r = a;
+            r.x -= static_cast<T>(b);
+            return r;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator-(S a, const Uncertain& b) {
+            return b.chain(static_cast<T>(a) - b.x, -1);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator*(const Uncertain& a, S b) {
+            return a.chain(a.x * static_cast<T>(b), static_cast<T>(b));
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator*(S a, const Uncertain& b) {
+            return b * a;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator/(const Uncertain& a, S b) {
+            const T inv = 1 / static_cast<T>(b);
+            return a.chain(a.x * inv, inv);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        friend constexpr Uncertain operator/(S a, const Uncertain& b) {
+            const T q = static_cast<T>(a) / b.x;
+            return b.chain(q, -q / b.x);
+        }
+
+        constexpr Uncertain operator+() const {
+            return *this;
+        }
+
+        constexpr Uncertain operator-() const {
+            return chain(-x, -1);
+        }
+
+        constexpr Uncertain& operator+=(const Uncertain& rhs) {
+            return *this = *this + rhs;
+        }
+
+        constexpr Uncertain& operator-=(const Uncertain& rhs) {
+            return *this = *this - rhs;
+        }
+
+        constexpr Uncertain& operator*=(const Uncertain& rhs) {
+            return *this = *this * rhs;
+        }
+
+        constexpr Uncertain& operator/=(const Uncertain& rhs) {
+            return *this = *this / rhs;
+        }
+
+        constexpr bool operator==(const Uncertain& rhs) const {
+            return x == rhs.x;
+        }
+
+        constexpr std::partial_ordering operator<=>(const Uncertain& rhs) const {
+            return x <=> rhs.x;
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        constexpr bool operator==(S rhs) const {
+            return x == static_cast<T>(rhs);
+        }
+
+        template <typename S> requires std::is_arithmetic_v<S>
+        constexpr std::partial_ordering operator<=>(S rhs) const {
+            return x <=> static_cast<T>(rhs);
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const Uncertain& u) {
+            return os << u.x << " ± " << u.sigma();
+        }
+
+        friend Uncertain abs(const Uncertain& u) {
+            return u.x < 0 ? -u : u;
+        }
+
+        friend Uncertain floor(const Uncertain& u) {
+            return Uncertain(std::floor(u.x));
+        }
+
+        friend Uncertain ceil(const Uncertain& u) {
+            return Uncertain(std::ceil(u.x));
+        }
+
+        friend Uncertain fmod(const Uncertain& a, const Uncertain& b) {
+            return a.chain(std::fmod(a.x, b.x), 1, b, -std::trunc(a.x / b.x));
+        }
+
+        friend Uncertain sqrt(const Uncertain& u) {
+            const T r = std::sqrt(u.x);
+            return u.chain(r, 1 / (2 * r));
+        }
+
+        friend Uncertain cbrt(const Uncertain& u) {
+            const T r = std::cbrt(u.x);
+            return u.chain(r, 1 / (3 * r * r));
+        }
+
+        friend Uncertain pow(const Uncertain& u, T p) {
+            return u.chain(std::pow(u.x, p), p * std::pow(u.x, p - 1));
+        }
+
+        friend Uncertain pow(const Uncertain& a, const Uncertain& b) {
+            const T r = std::pow(a.x, b.x);
+            return a.chain(r, b.x * std::pow(a.x, b.x - 1), b, a.x > 0 ? r * std::log(a.x) : T(0));
+        }
+
+        friend Uncertain exp(const Uncertain& u) {
+            const T r = std::exp(u.x);
+            return u.chain(r, r);
+        }
+
+        friend Uncertain log(const Uncertain& u) {
+            return u.chain(std::log(u.x), 1 / u.x);
+        }
+
+        friend Uncertain hypot(const Uncertain& a, const Uncertain& b) {
+            const T r = std::hypot(a.x, b.x);
+            return a.chain(r, a.x / r, b, b.x / r);
+        }
+
+        friend Uncertain hypot(const Uncertain& a, const Uncertain& b, const Uncertain& c) {
+            const T r = std::hypot(a.x, b.x, c.x);
+            return a.chain(r, a.x / r, b, b.x / r).chain(r, 1, c, c.x / r);
+        }
+
+        friend Uncertain sin(const Uncertain& u) {
+            return u.chain(std::sin(u.x), std::cos(u.x));
+        }
+
+        friend Uncertain cos(const Uncertain& u) {
+            return u.chain(std::cos(u.x), -std::sin(u.x));
+        }
+
+        friend Uncertain tan(const Uncertain& u) {
+            const T r = std::tan(u.x);
+            return u.chain(r, 1 + r * r);
+        }
+
+        friend Uncertain asin(const Uncertain& u) {
+            return u.chain(std::asin(u.x), 1 / std::sqrt((1 - u.x) * (1 + u.x)));
+        }
+
+        friend Uncertain acos(const Uncertain& u) {
+            return u.chain(std::acos(u.x), -1 / std::sqrt((1 - u.x) * (1 + u.x)));
+        }
+
+        friend Uncertain atan(const Uncertain& u) {
+            return u.chain(std::atan(u.x), 1 / (1 + u.x * u.x));
+        }
+
+        friend Uncertain atan2(const Uncertain& y, const Uncertain& x) {
+            const T inv = 1 / (x.x * x.x + y.x * y.x);
+            return y.chain(std::atan2(y.x, x.x), x.x * inv, x, -y.x * inv);
+        }
+    };
+
+    template <typename T, bool Correlated>
+    struct accumulator<Uncertain<T, Correlated>> {
+        using type = Uncertain<accumulator_t<T>, Correlated>;
+    };
+
+    // value ± sigma in the unit of value; sigma may be given in any unit of the same dimension.
+    template <bool Correlated = false, typename U1, typename T, typename U2, typename V2>
+        requires std::is_same_v<pure_unit_t<U1>, pure_unit_t<U2>>
+    Quantity<U1, Uncertain<T, Correlated>> measured(const Quantity<U1, T>& value, const Quantity<U2, V2>& sigma) {
+        using V = Uncertain<T, Correlated>;
+        return Quantity<U1, V>(V(value.value, Quantity<U1, T>{sigma}.value));
+    }
+
+    template <typename U, typename T, bool Correlated>
+    constexpr Quantity<U, T> nominal(const Quantity<U, Uncertain<T, Correlated>>& q) {
+        return Quantity<U, T>(q.value.x);
+    }
+
+    template <typename U, typename T, bool Correlated>
+    constexpr Quantity<U, T> uncertainty(const Quantity<U, Uncertain<T, Correlated>>& q) {
+        return Quantity<U, T>(q.value.sigma());
+    }
+
+    // Structure-of-arrays list of uncorrelated Uncertain quantities: values and variances are stored in separate
+    // arrays, and the element-wise operators below run as plain loops over them that the compiler vectorizes.
+    template <typename Q>
+    struct UncertainList {
+        static_assert(is_quantity_v<Q>, "UncertainList requires a Quantity type.");
+
+        using uncertain_type = typename Q::value_type;
+        using scalar_type = typename uncertain_type::scalar_type;
+        static_assert(std::is_same_v<uncertain_type, Uncertain<scalar_type>>,
+                      "UncertainList requires an uncorrelated Uncertain value type.");
+
+        std::vector<scalar_type> value;
+        std::vector<scalar_type> variance;
+
+        UncertainList() = default;
+
+        explicit UncertainList(size_t n) : value(n), variance(n) {
+        }
+
+        size_t size() const {
+            return value.size();
+        }
+
+        bool empty() const {
+            return value.empty();
+        }
+
+        void reserve(size_t n) {
+            value.reserve(n);
+            variance.reserve(n);
+        }
+
+        void clear() {
+            value.clear();
+            variance.clear();
+        }
+
+        void push_back(const Q& q) {
+            value.push_back(q.value.x);
+            variance.push_back(q.value.error);
+        }
+
+        Q operator[](size_t i) const {
+            uncertain_type u(value[i]);
+            u.error = variance[i];
+            return Q(u);
+        }
+
+        void set(size_t i, const Q& q) {
+            value[i] = q.value.x;
+            variance[i] = q.value.error;
+        }
+    };
+
+    // Element-wise operations on lists of equal size, with the same uncertainties as the scalar operators.
+    template <typename Q>
+    UncertainList<Q> operator+(const UncertainList<Q>& a, const UncertainList<Q>& b) {
+        UncertainList<Q> out(a.size());
+        const auto *av = a.value.data(), *as = a.variance.data(), *bv = b.value.data(), *bs = b.variance.data();
+        auto *ov = out.value.data(), *os = out.variance.data();
+        for (size_t i = 0; i < out.size(); ++i) {
+            ov[i] = av[i] + bv[i];
+            os[i] = as[i] + bs[i];
+        }
+        return out;
+    }
+
+    template <typename Q>
+    UncertainList<Q> operator-(const UncertainList<Q>& a, const UncertainList<Q>& b) {
+        UncertainList<Q> out(a.size());
+        const auto *av = a.value.data(), *as = a.variance.data(), *bv = b.value.data(), *bs = b.variance.data();
+        auto *ov = out.value.data(), *os = out.variance.data();
+        for (size_t i = 0; i < out.size(); ++i) {
+            ov[i] = av[i] - bv[i];
+            os[i] = as[i] + bs[i];
+        }
+        return out;
+    }
+
+    template <typename QA, typename QB>
+    auto operator*(const UncertainList<QA>& a, const UncertainList<QB>& b) {
+        using R = decltype(QA{} * QB{});
+        static_assert(is_quantity_v<R>, "The product of two UncertainLists must have a unit.");
+        UncertainList<R> out(a.size());
+        const auto *av = a.value.data(), *as = a.variance.data(), *bv = b.value.data(), *bs = b.variance.data();
+        auto *ov = out.value.data(), *os = out.variance.data();
+        for (size_t i = 0; i < out.size(); ++i) {
+            ov[i] = av[i] * bv[i];
+            os[i] = bv[i] * bv[i] * as[i] + av[i] * av[i] * bs[i];
+        }
+        return out;
+    }
+
+    template <typename QA, typename QB>
+    auto operator/(const UncertainList<QA>& a, const UncertainList<QB>& b) {
+        using R = decltype(QA{} / QB{});
+        static_assert(is_quantity_v<R>, "The quotient of two UncertainLists must have a unit.");
+        UncertainList<R> out(a.size());
+        const auto *av = a.value.data(), *as = a.variance.data(), *bv = b.value.data(), *bs = b.variance.data();
+        auto *ov = out.value.data(), *os = out.variance.data();
+        for (size_t i = 0; i < out.size(); ++i) {
+            const auto inv = 1 / bv[i];
+            const auto q = av[i] * inv;
+            ov[i] = q;
+            os[i] = inv * inv * (as[i] + q * q * bs[i]);
+        }
+        return out;
+    }
+}
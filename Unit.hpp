@@ -12,10 +12,17 @@
 #pragma once
 
 #include <tuple>
+#include <utility>
 #include <type_traits>
 #include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <cmath>
+#include <ranges>
 #include <ratio>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <chrono>
 #include <thread>
 
@@ -96,6 +103,17 @@ namespace Unit {
     struct is_unit<Unit<Tpl, E, S, R>> : std::true_type {
     };
 
+    template <typename T>
+    struct is_quantity : std::false_type {
+    };
+
+    template <typename U, typename V>
+    struct is_quantity<Quantity<U, V>> : std::true_type {
+    };
+
+    template <typename T>
+    inline constexpr auto is_quantity_v = is_quantity<T>::value;
+
     template <typename T>
     struct get_exponent {
         static constexpr int value = 1;
@@ -132,20 +150,6 @@ namespace Unit {
         }();
     };
 
-    constexpr float_t ipow(float_t base, int exp) {
-        float_t res = 1.0;
-        if (exp < 0) {
-            base = 1.0 / base;
-            exp = -exp;
-        }
-        while (exp > 0) {
-            if (exp % 2 == 1) res *= base;
-            base *= base;
-            exp /= 2;
-        }
-        return res;
-    }
-
     static constexpr float_t pi = 3.14159265358979323846;
 
     template <FixedString Symbol>
@@ -161,27 +165,182 @@ namespace Unit {
         using R = Ratio;
     };
 
-    template <typename T>
-    constexpr float_t get_unit_scale();
+    // Ratio * pi^PiExp as the Ratio of a Unit, for units defined through pi such as deg.
+    template <typename Ratio, int PiExp = 1>
+    struct pi_ratio {
+        using ratio = Ratio;
+        static constexpr int pi_exp = PiExp;
+    };
 
-    template <typename Tuple>
-    constexpr float_t tuple_scale_product() {
-        constexpr size_t N = std::tuple_size_v<Tuple>;
-        if constexpr (N == 0) return 1.0;
-        else {
-            return []<size_t... I>(std::index_sequence<I...>) {
-                return (... * get_unit_scale<std::tuple_element_t<I, Tuple>>());
-            }(std::make_index_sequence<N>{});
+    // The scale num / den * pi^pi_exp of a unit, or between two units, kept exact so that conversion factors are
+    // rounded only once, when they are finally cast to the value type. Terms that would overflow intmax_t make the
+    // scale inexact, after which it continues in long double as `approx`.
+    struct ExactScale {
+        intmax_t num = 1;
+        intmax_t den = 1;
+        int pi_exp = 0;
+        bool exact = true;
+        long double approx = 1;
+
+        constexpr bool is_one() const {
+            return exact && num == 1 && den == 1 && pi_exp == 0;
+        }
+
+        constexpr bool is_rational() const {
+            return exact && pi_exp == 0;
+        }
+
+        constexpr ExactScale operator*(const ExactScale& rhs) const {
+            ExactScale r;
+            r.pi_exp = pi_exp + rhs.pi_exp;
+            r.approx = approx * rhs.approx;
+            r.exact = exact && rhs.exact;
+            if (r.exact) {
+                const intmax_t g1 = std::gcd(num, rhs.den), g2 = std::gcd(rhs.num, den);
+                r.exact = multiply(num / g1, rhs.num / g2, r.num) && multiply(den / g2, rhs.den / g1, r.den);
+            }
+            return r;
+        }
+
+        constexpr ExactScale inverse() const {
+            return ExactScale{den, num, -pi_exp, exact, 1 / approx};
+        }
+
+        constexpr ExactScale operator/(const ExactScale& rhs) const {
+            return *this * rhs.inverse();
+        }
+
+        constexpr ExactScale pow(int exp) const {
+            ExactScale r;
+            for (int i = 0; i < (exp < 0 ? -exp : exp); ++i) r = r * *this;
+            return exp < 0 ? r.inverse() : r;
+        }
+
+    private:
+        static constexpr bool multiply(intmax_t a, intmax_t b, intmax_t& out) {
+            if (b != 0 && a > std::numeric_limits<intmax_t>::max() / b) return false;
+            out = a * b;
+            return true;
         }
+    };
+
+    // s as a T. Rationals whose terms T represents exactly are correctly rounded by a single division in T; the
+    // rest is evaluated in long double.
+    template <typename T>
+    constexpr T scale_as(const ExactScale& s) {
+        constexpr int digits = std::numeric_limits<T>::digits;
+        constexpr intmax_t limit = digits >= 63 ? std::numeric_limits<intmax_t>::max() : intmax_t{1} << digits;
+        if (s.is_rational() && s.num <= limit && s.den <= limit) return static_cast<T>(s.num) / static_cast<T>(s.den);
+        long double v = s.exact ? static_cast<long double>(s.num) / static_cast<long double>(s.den) : s.approx;
+        for (int i = 0; i < s.pi_exp; ++i) v *= 3.14159265358979323846264338327950288L;
+        for (int i = 0; i > s.pi_exp; --i) v /= 3.14159265358979323846264338327950288L;
+        return static_cast<T>(v);
     }
 
+    template <typename Ratio>
+    inline constexpr ExactScale ratio_scale_v = ExactScale{
+        Ratio::num, Ratio::den, 0, true, static_cast<long double>(Ratio::num) / Ratio::den
+    };
+
+    template <typename Ratio, int PiExp>
+    inline constexpr ExactScale ratio_scale_v<pi_ratio<Ratio, PiExp>> = ExactScale{
+        Ratio::num, Ratio::den, PiExp, true, static_cast<long double>(Ratio::num) / Ratio::den
+    };
+
+    // Scale of a unit relative to its base units.
+    template <typename T>
+    inline constexpr ExactScale unit_scale_v = ExactScale{};
+
+    template <typename Tpl, int E, FixedString S, typename R>
+    inline constexpr ExactScale unit_scale_v<Unit<Tpl, E, S, R>> = [] {
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return (ratio_scale_v<R> * ... * unit_scale_v<std::tuple_element_t<I, Tpl>>);
+        }(std::make_index_sequence<std::tuple_size_v<Tpl>>{}).pow(E);
+    }();
+
     template <typename T>
     constexpr float_t get_unit_scale() {
-        if constexpr (is_base_unit_v<T>) {
-            return 1.0;
+        return scale_as<float_t>(unit_scale_v<T>);
+    }
+
+    // Scale that converts values in From to values in To.
+    template <typename From, typename To>
+    inline constexpr ExactScale conversion_scale_v = unit_scale_v<From> / unit_scale_v<To>;
+
+    template <typename T, typename From, typename To>
+    constexpr T conversion_factor() {
+        return scale_as<T>(conversion_scale_v<From, To>);
+    }
+
+    // conversion_scale_v as the Ratio of a Unit: a std::ratio, or a pi_ratio if it involves pi.
+    template <typename From, typename To> requires (conversion_scale_v<From, To>.exact)
+    using conversion_ratio_t = std::conditional_t<
+        conversion_scale_v<From, To>.pi_exp == 0,
+        std::ratio<conversion_scale_v<From, To>.num, conversion_scale_v<From, To>.den>,
+        pi_ratio<std::ratio<conversion_scale_v<From, To>.num, conversion_scale_v<From, To>.den>,
+                 conversion_scale_v<From, To>.pi_exp>
+    >;
+
+    // Value types whose conversions are done with integer arithmetic. Fixed-point types specialize this with
+    // their raw representation and the number of fractional bits.
+    template <typename V>
+    struct exact_value_traits {
+        static constexpr bool value = std::is_integral_v<V> && !std::is_same_v<V, bool>;
+        static constexpr int frac_bits = 0;
+        using rep = V;
+
+        static constexpr rep to_raw(V v) {
+            return v;
+        }
+
+        static constexpr V from_raw(rep r) {
+            return r;
+        }
+    };
+
+    template <typename V>
+    inline constexpr bool is_exact_value_v = exact_value_traits<V>::value;
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef __int128 exact_wide_t;
+#else
+    using exact_wide_t = long long;
+#endif
+
+    // Multiplies by Ratio in a wide integer and truncates toward zero like std::chrono::duration_cast.
+    // Pure divisions stay in the source representation. Throws std::overflow_error if an intermediate or the
+    // result does not fit.
+    template <typename Ratio, typename To, typename From>
+    constexpr To convert_exact(const From& v) {
+        using FromTraits = exact_value_traits<From>;
+        using ToTraits = exact_value_traits<To>;
+        using FromRep = FromTraits::rep;
+        using ToRep = ToTraits::rep;
+        constexpr int shift = ToTraits::frac_bits - FromTraits::frac_bits;
+        constexpr exact_wide_t num = static_cast<exact_wide_t>(Ratio::num) << (shift > 0 ? shift : 0);
+        constexpr exact_wide_t den = static_cast<exact_wide_t>(Ratio::den) << (shift < 0 ? -shift : 0);
+
+        if constexpr (num == 1 && den <= static_cast<exact_wide_t>(std::numeric_limits<FromRep>::max())) {
+            FromRep raw = FromTraits::to_raw(v);
+            if constexpr (den != 1) raw = static_cast<FromRep>(raw / static_cast<FromRep>(den));
+            if (!std::in_range<ToRep>(raw)) throw std::overflow_error("Unit conversion overflow");
+            return ToTraits::from_raw(static_cast<ToRep>(raw));
         } else {
-            float_t inner = tuple_scale_product<typename T::Units>();
-            return ipow(inner * (static_cast<float_t>(T::R::num) / static_cast<float_t>(T::R::den)), T::Exp);
+            constexpr exact_wide_t wide_max = std::numeric_limits<exact_wide_t>::max();
+            exact_wide_t raw = static_cast<exact_wide_t>(FromTraits::to_raw(v));
+            if constexpr (num != 1) {
+                // Compared against both bounds, since negating the most negative raw value would overflow.
+                if (raw > wide_max / num || raw < -(wide_max / num)) {
+                    throw std::overflow_error("Unit conversion overflow");
+                }
+                raw *= num;
+            }
+            if constexpr (den != 1) raw /= den;
+            if (raw < static_cast<exact_wide_t>(std::numeric_limits<ToRep>::min()) ||
+                raw > static_cast<exact_wide_t>(std::numeric_limits<ToRep>::max())) {
+                throw std::overflow_error("Unit conversion overflow");
+            }
+            return ToTraits::from_raw(static_cast<ToRep>(raw));
         }
     }
 
@@ -495,9 +654,113 @@ namespace Unit {
     template <typename U1, typename U2, int Sign>
     using binary_op_result_t = binary_op_result<U1, U2, Sign>::type;
 
+    template <typename Tuple, int Num, int Den>
+    struct scale_exponents;
+
+    template <typename... Terms, int Num, int Den>
+    struct scale_exponents<std::tuple<Terms...>, Num, Den> {
+        static constexpr bool value = ((Terms::Exp * Num % Den == 0) && ...);
+        using type = std::tuple<Unit<typename Terms::Units, Terms::Exp * Num / Den>...>;
+    };
+
+    template <typename Term>
+    struct unwrap_term {
+        using type = Term;
+    };
+
+    template <typename Tpl, int E, FixedString S, typename R>
+    struct unwrap_term<Unit<std::tuple<Unit<Tpl, E, S, R>>, 1>> {
+        using type = Unit<Tpl, E, S, R>;
+    };
+
+    // Unit of U^(Num/Den). The exponents of U's own terms are scaled first so that sqrt(km^2) stays in km; if
+    // that leaves a fractional exponent, e.g. cbrt(L), U is decomposed into base units and tried again.
+    template <typename U, int Num, int Den = 1>
+    struct pow_result {
+        using OwnTerms = filter_zero_t<merge_all_t<std::tuple<>, flatten_t<U, 1>>>;
+        using BaseTerms = filter_zero_t<merge_all_t<std::tuple<>, decompose_t<U, 1>>>;
+        static constexpr bool own = scale_exponents<OwnTerms, Num, Den>::value;
+        static_assert(own || scale_exponents<BaseTerms, Num, Den>::value,
+                      "The resulting unit would have a non-integral exponent.");
+
+        using Terms = scale_exponents<std::conditional_t<own, OwnTerms, BaseTerms>, Num, Den>::type;
+        using type = unwrap_term<reconstruct_t<filter_zero_t<Terms>>>::type;
+    };
+
+    template <typename U, int Num, int Den = 1>
+    using pow_result_t = pow_result<U, Num, Den>::type;
+
+    // Value types that bound their own rounding errors, such as Interval. Quantities of them are scaled by the exact
+    // ratio between two units, as a multiplication by its numerator and a division by its denominator, since a
+    // rounded floating-point factor would break the bounds.
+    template <typename V>
+    inline constexpr bool is_bounded_value_v = false;
+
+    template <typename U, typename V>
+    inline constexpr bool is_bounded_value_v<Quantity<U, V>> = is_bounded_value_v<V>;
+
+    // Answer of a predicate over bounded values: whether it holds for every, some, or none of the values within
+    // the bounds.
+    enum class Certainty {
+        Never,
+        Maybe,
+        Definitely
+    };
+
+    // Scales involving pi, or too large to be exact, are multiplied in as their long double value.
+    template <ExactScale Scale, typename V>
+    constexpr V scale_bounded(const V& v) {
+        if constexpr (!Scale.is_rational()) return v * V(scale_as<long double>(Scale));
+        else if constexpr (Scale.num == 1 && Scale.den == 1) return v;
+        else if constexpr (Scale.den == 1) return v * V(Scale.num);
+        else if constexpr (Scale.num == 1) return v / V(Scale.den);
+        else return v * V(Scale.num) / V(Scale.den);
+    }
+
+    // Value type of an operation mixing value types A and B. Built-in types follow std::common_type, so float stays
+    // float and integers widen to floating point instead of truncating it; otherwise it is the type of A * B, so
+    // that value types such as Dual win over the built-in scalars they are combined with.
+    template <typename A, typename B>
+    struct promote_value {
+        using type = decltype(std::declval<A>() * std::declval<B>());
+    };
+
+    template <typename A, typename B> requires std::is_arithmetic_v<A> && std::is_arithmetic_v<B>
+    struct promote_value<A, B> {
+        using type = std::common_type_t<A, B>;
+    };
+
+    template <typename A, typename B>
+    using promote_value_t = promote_value<A, B>::type;
+
+    // Floating-point type unit scale factors are applied in for values of type V: V itself if it is floating-point,
+    // so that float quantities are not widened to double and back, otherwise float_t.
+    template <typename V>
+    using scale_value_t = std::conditional_t<std::is_floating_point_v<V>, V, float_t>;
+
+    // Type of a dimensionless product or quotient computed as V: float_t for the integral and exact value types,
+    // otherwise V itself, so that float stays float and value types carrying more than a number (e.g. Dual) keep it.
+    template <typename V>
+    using dimensionless_value_t = std::conditional_t<
+        !std::is_floating_point_v<V> && std::is_constructible_v<float_t, V>,
+        float_t,
+        V
+    >;
+
+    // An arithmetic scalar S that quantities with value type V can be multiplied and divided by: any, if V is
+    // arithmetic too, otherwise one that V can be scaled by without leaving V.
+    template <typename S, typename V>
+    concept compound_scalar = std::is_arithmetic_v<S> && (std::is_arithmetic_v<V> || requires(V v, S s) {
+        { v * s } -> std::same_as<V>;
+        { s * v } -> std::same_as<V>;
+        { v / s } -> std::same_as<V>;
+        { s / v } -> std::same_as<V>;
+    });
+
     template <typename ThisUnit, typename ValueType>
     struct Quantity {
         using u = ThisUnit;
+        using value_type = ValueType;
         ValueType value;
 
         explicit constexpr Quantity(ValueType v = 0) : value(v) {
@@ -510,10 +773,20 @@ namespace Unit {
         ) {
             if constexpr (std::is_same_v<ThisUnit, OtherUnit>) {
                 value = static_cast<ValueType>(other.value);
+            } else if constexpr (is_exact_value_v<ValueType> && is_exact_value_v<OtherValue> &&
+                                 conversion_scale_v<OtherUnit, ThisUnit>.is_rational()) {
+                value = convert_exact<conversion_ratio_t<OtherUnit, ThisUnit>, ValueType>(other.value);
+            } else if constexpr (is_bounded_value_v<ValueType>) {
+                value = scale_bounded<conversion_scale_v<OtherUnit, ThisUnit>>(static_cast<ValueType>(other.value));
+            } else if constexpr (conversion_scale_v<OtherUnit, ThisUnit>.is_one()) {
+                value = static_cast<ValueType>(other.value);
+            } else if constexpr (is_exact_value_v<OtherValue>) {
+                constexpr auto factor = conversion_factor<float_t, OtherUnit, ThisUnit>();
+                value = static_cast<ValueType>(static_cast<float_t>(other.value) * factor);
             } else {
-                constexpr ValueType from_scale = get_unit_scale<ThisUnit>();
-                constexpr ValueType to_scale = get_unit_scale<OtherUnit>();
-                value = static_cast<ValueType>(other.value * (to_scale / from_scale));
+                using Scale = scale_value_t<promote_value_t<ValueType, OtherValue>>;
+                constexpr auto factor = conversion_factor<Scale, OtherUnit, ThisUnit>();
+                value = static_cast<ValueType>(other.value * factor);
             }
         }
 
@@ -527,12 +800,17 @@ namespace Unit {
         constexpr auto operator*(const Quantity<OtherUnit, OtherValue>& rhs) const {
             using ResultUnit = binary_op_result_t<ThisUnit, OtherUnit, 1>;
 
-            if constexpr (std::tuple_size_v<typename ResultUnit::Units> == 0) {
-                constexpr float_t lhs_scale = get_unit_scale<ThisUnit>();
-                constexpr float_t rhs_scale = get_unit_scale<OtherUnit>();
-                return static_cast<float_t>((value * lhs_scale) * (rhs.value * rhs_scale));
+            if constexpr (std::tuple_size_v<typename ResultUnit::Units> == 0 &&
+                          is_bounded_value_v<decltype(value * rhs.value)>) {
+                return scale_bounded<unit_scale_v<ThisUnit> * unit_scale_v<OtherUnit>>(value * rhs.value);
+            } else if constexpr (std::tuple_size_v<typename ResultUnit::Units> == 0) {
+                using Scale = scale_value_t<promote_value_t<ValueType, OtherValue>>;
+                constexpr auto factor = scale_as<Scale>(unit_scale_v<ThisUnit> * unit_scale_v<OtherUnit>);
+                auto result = (value * factor) * rhs.value;
+                return static_cast<dimensionless_value_t<decltype(result)>>(result);
             } else {
-                return Quantity<ResultUnit, decltype(value * rhs.value)>(value * rhs.value);
+                using R = promote_value_t<ValueType, OtherValue>;
+                return Quantity<ResultUnit, R>(static_cast<R>(value * rhs.value));
             }
         }
 
@@ -540,12 +818,17 @@ namespace Unit {
         constexpr auto operator/(const Quantity<OtherUnit, OtherValue>& rhs) const {
             using ResultUnit = binary_op_result_t<ThisUnit, OtherUnit, -1>;
 
-            if constexpr (std::tuple_size_v<typename ResultUnit::Units> == 0) {
-                constexpr float_t lhs_scale = get_unit_scale<ThisUnit>();
-                constexpr float_t rhs_scale = get_unit_scale<OtherUnit>();
-                return static_cast<float_t>((value * lhs_scale) / (rhs.value * rhs_scale));
+            if constexpr (std::tuple_size_v<typename ResultUnit::Units> == 0 &&
+                          is_bounded_value_v<decltype(value / rhs.value)>) {
+                return scale_bounded<unit_scale_v<ThisUnit> / unit_scale_v<OtherUnit>>(value / rhs.value);
+            } else if constexpr (std::tuple_size_v<typename ResultUnit::Units> == 0) {
+                using Scale = scale_value_t<promote_value_t<ValueType, OtherValue>>;
+                constexpr auto factor = scale_as<Scale>(unit_scale_v<ThisUnit> / unit_scale_v<OtherUnit>);
+                auto result = (value * factor) / rhs.value;
+                return static_cast<dimensionless_value_t<decltype(result)>>(result);
             } else {
-                return Quantity<ResultUnit, decltype(value / rhs.value)>(value / rhs.value);
+                using R = promote_value_t<ValueType, OtherValue>;
+                return Quantity<ResultUnit, R>(static_cast<R>(value / rhs.value));
             }
         }
 
@@ -567,6 +850,34 @@ namespace Unit {
             return Quantity<ResultUnit, ValueType>(lhs / rhs.value);
         }
 
+        // Other built-in scalars promote the value type (px * 1.5 is stored as double rather than truncated), and scale
+        // compound value types such as Dual directly instead of being converted to them first.
+        template <typename S> requires compound_scalar<S, ValueType>
+        constexpr auto operator*(S rhs) const {
+            using R = promote_value_t<ValueType, S>;
+            return Quantity<ThisUnit, R>(static_cast<R>(value * rhs));
+        }
+
+        template <typename S> requires compound_scalar<S, ValueType>
+        constexpr auto operator/(S rhs) const {
+            using R = promote_value_t<ValueType, S>;
+            return Quantity<ThisUnit, R>(static_cast<R>(value / rhs));
+        }
+
+        template <typename S> requires compound_scalar<S, ValueType>
+        friend constexpr auto operator*(S lhs, const Quantity& rhs) {
+            using R = promote_value_t<ValueType, S>;
+            return Quantity<ThisUnit, R>(static_cast<R>(lhs * rhs.value));
+        }
+
+        template <typename S> requires compound_scalar<S, ValueType>
+        friend constexpr auto operator/(S lhs, const Quantity& rhs) {
+            using Dimensionless = Unit<std::tuple<>, 0>;
+            using ResultUnit = binary_op_result_t<Dimensionless, ThisUnit, -1>;
+            using R = promote_value_t<ValueType, S>;
+            return Quantity<ResultUnit, R>(static_cast<R>(lhs / rhs.value));
+        }
+
         constexpr auto operator+(const Quantity& rhs) const {
             return Quantity(value + rhs.value);
         }
@@ -575,8 +886,39 @@ namespace Unit {
             return Quantity(value - rhs.value);
         }
 
+        // Same unit, different value type: computed in the promoted type rather than converting rhs to ValueType.
+        template <typename OtherValue> requires (!std::is_same_v<ValueType, OtherValue>)
+        constexpr auto operator+(const Quantity<ThisUnit, OtherValue>& rhs) const {
+            using R = promote_value_t<ValueType, OtherValue>;
+            return Quantity<ThisUnit, R>(static_cast<R>(value + rhs.value));
+        }
+
+        template <typename OtherValue> requires (!std::is_same_v<ValueType, OtherValue>)
+        constexpr auto operator-(const Quantity<ThisUnit, OtherValue>& rhs) const {
+            using R = promote_value_t<ValueType, OtherValue>;
+            return Quantity<ThisUnit, R>(static_cast<R>(value - rhs.value));
+        }
+
         constexpr auto operator<=>(const Quantity& rhs) const = default;
 
+        // Forwarded rather than derived from <=>, so value types whose comparisons are not a total or partial order
+        // (e.g. Interval, where a < b only if it holds for every value in the bounds) keep their meaning.
+        constexpr auto operator<(const Quantity& rhs) const {
+            return value < rhs.value;
+        }
+
+        constexpr auto operator<=(const Quantity& rhs) const {
+            return value <= rhs.value;
+        }
+
+        constexpr auto operator>(const Quantity& rhs) const {
+            return value > rhs.value;
+        }
+
+        constexpr auto operator>=(const Quantity& rhs) const {
+            return value >= rhs.value;
+        }
+
         template <typename OtherUnit>
             requires std::same_as<Quantity, decltype(Quantity() + Quantity<OtherUnit, ValueType>())>
         constexpr auto& operator+=(const Quantity<OtherUnit, ValueType>& rhs) {
@@ -613,8 +955,13 @@ namespace Unit {
             return Quantity(-value);
         }
 
+        // Dimensionless quantities, e.g. from ratio_of, convert to the number they stand for with their scale applied.
         explicit operator ValueType() const {
-            return value;
+            if constexpr (std::tuple_size_v<typename pure_unit_t<ThisUnit>::Units> == 0) {
+                return Quantity<Unit<std::tuple<>>, ValueType>{*this}.value;
+            } else {
+                return value;
+            }
         }
     };
 
@@ -623,42 +970,377 @@ namespace Unit {
     template <FixedString Sym, int Exp = 1>
     using base_unit_q = Quantity<base_unit<Sym, Exp>>;
 
-    template <typename U, FixedString Sym, typename Ratio = std::ratio<1>, int Exp = U::Exp>
-    using compound_unit = Unit<
-        typename U::Units,
-        Exp,
-        Sym,
-        Ratio
+    template <typename Q, typename V>
+    using with_value_t = Quantity<typename Q::u, V>;
+
+    template <typename Q, int Num, int Den = 1>
+    using pow_t = Quantity<pow_result_t<typename Q::u, Num, Den>, typename Q::value_type>;
+
+    // Re-types the storage of quantities that use the default float_t, leaving e.g. px's unsigned alone.
+    template <typename Q, typename V>
+    using storage_rebind_t = std::conditional_t<
+        std::is_same_v<typename Q::value_type, float_t>,
+        with_value_t<Q, V>,
+        Q
     >;
 
+    // Units with a scale of their own (mi, B, dm^3) are kept as the single term of the new unit, so that the scale
+    // is multiplied in rather than replaced by Ratio; another Exp then raises that term, e.g. mi^2 for a square mile.
+    template <typename U, FixedString Sym, typename Ratio, int Exp>
+    struct compound_unit_of {
+        static_assert(std::is_same_v<typename U::R, std::ratio<1>> || Exp % U::Exp == 0,
+                      "The exponent of a compound unit must be a multiple of the exponent of a scaled unit.");
+        using type = std::conditional_t<
+            std::is_same_v<typename U::R, std::ratio<1>>,
+            Unit<typename U::Units, Exp, Sym, Ratio>,
+            std::conditional_t<
+                Exp == U::Exp,
+                Unit<std::tuple<U>, 1, Sym, Ratio>,
+                Unit<std::tuple<Unit<std::tuple<U>, Exp / U::Exp>>, 1, Sym, Ratio>
+            >
+        >;
+    };
+
+    template <typename U, FixedString Sym, typename Ratio = std::ratio<1>, int Exp = U::Exp>
+    using compound_unit = compound_unit_of<U, Sym, Ratio, Exp>::type;
+
     template <typename Q, FixedString Sym, typename Ratio = std::ratio<1>, int Exp = Q::u::Exp>
-    using compound_unit_q = Quantity<compound_unit<typename Q::u, Sym, Ratio, Exp>>;
+    using compound_unit_q = Quantity<compound_unit<typename Q::u, Sym, Ratio, Exp>, typename Q::value_type>;
 
+    // Exp is the power of the prefixed unit, e.g. (dm)^3 for deci<m, 3> and (kHz)^1 for kilo<Hz>.
     template <typename U, FixedString Prefix, typename Ratio = std::ratio<1>, int Exp = U::Exp>
-    using scaled_unit = compound_unit<U, Prefix + get_symbol_v<U>, Ratio, Exp>;
+    using scaled_unit = std::conditional_t<
+        std::is_same_v<typename U::R, std::ratio<1>> && U::Exp == 1,
+        Unit<typename U::Units, Exp, Prefix + get_symbol_v<U>, Ratio>,
+        Unit<std::tuple<U>, Exp, Prefix + get_symbol_v<U>, Ratio>
+    >;
 
     template <typename Q, FixedString Prefix, typename Ratio = std::ratio<1>, int Exp = Q::u::Exp>
-    using scaled_unit_q = Quantity<scaled_unit<typename Q::u, Prefix, Ratio, Exp>>;
+    using scaled_unit_q = Quantity<scaled_unit<typename Q::u, Prefix, Ratio, Exp>, typename Q::value_type>;
+
+    // "x" followed by Ratio, e.g. "x1000", "x1/1000" or "x1/180*pi"; empty for 1.
+    template <typename Ratio>
+    constexpr auto ratio_symbol() {
+        if constexpr (requires { Ratio::pi_exp; }) {
+            constexpr auto rational = ratio_symbol<typename Ratio::ratio>();
+            constexpr int exp = Ratio::pi_exp < 0 ? -Ratio::pi_exp : Ratio::pi_exp;
+            static_assert(exp < 10, "ratio_symbol supports powers of pi below 10.");
+            constexpr auto pi_part = [] {
+                constexpr auto factor = FixedString(Ratio::pi_exp > 0 ? "*pi" : "/pi");
+                if constexpr (exp == 1) {
+                    return factor;
+                } else {
+                    constexpr char power[3] = {'^', static_cast<char>('0' + exp), '\0'};
+                    return factor + FixedString<3>(power, 3);
+                }
+            }();
+            if constexpr (rational.empty()) return FixedString("x1") + pi_part;
+            else return rational + pi_part;
+        } else if constexpr (Ratio::num == 1 && Ratio::den == 1) {
+            return FixedString("");
+        } else {
+            constexpr auto digits = [](intmax_t v) {
+                size_t n = 1;
+                for (; v >= 10; v /= 10) ++n;
+                return n;
+            };
+            constexpr size_t num_digits = digits(Ratio::num);
+            constexpr size_t den_digits = Ratio::den == 1 ? 0 : digits(Ratio::den) + 1;
+            constexpr size_t N = num_digits + den_digits + 2;
+            char buf[N]{'x'};
+            for (intmax_t v = Ratio::num, i = num_digits; i > 0; v /= 10) buf[i--] = static_cast<char>('0' + v % 10);
+            if constexpr (Ratio::den != 1) {
+                buf[num_digits + 1] = '/';
+                for (intmax_t v = Ratio::den, i = N - 2; i > static_cast<intmax_t>(num_digits + 1); v /= 10) {
+                    buf[i--] = static_cast<char>('0' + v % 10);
+                }
+            }
+            return FixedString<N>(buf, N);
+        }
+    }
+
+    // Dimensionless unit whose values are in units of Ratio, so that a ratio of quantities in different units can be
+    // stored without multiplying by the scale between them. Ratio 1 is the plain dimensionless unit.
+    template <typename Ratio>
+    using ratio_unit = Unit<std::tuple<>, 1, ratio_symbol<Ratio>(), Ratio>;
+
+    // a / b as a typed dimensionless quantity: the quotient of the raw values in the ratio_unit of the scale between
+    // the units of a and b, which is only applied when it is converted (e.g. ratio_of(3_km, 2_m) is 1.5 x1000, and
+    // static_cast<float_t> of it is 1500). Unlike a / b, this costs one division for any pair of units and keeps
+    // floating-point value types; integer values are divided as float_t, so ratio_of(px(3), px(2)) is 1.5.
+    template <typename UA, typename VA, typename UB, typename VB>
+        requires std::is_same_v<pure_unit_t<UA>, pure_unit_t<UB>>
+    constexpr auto ratio_of(const Quantity<UA, VA>& a, const Quantity<UB, VB>& b) {
+        using R = dimensionless_value_t<promote_value_t<VA, VB>>;
+        using Unit = ratio_unit<conversion_ratio_t<UA, UB>>;
+        return Quantity<Unit, R>(static_cast<R>(a.value) / static_cast<R>(b.value));
+    }
+
+    // IEEE 754 binary16 storage type. It converts implicitly to float, so arithmetic on half quantities is done in
+    // float and only rounded back to 16 bits when stored.
+    struct Half {
+        uint16_t bits;
+
+        constexpr Half() : bits(0) {
+        }
+
+        // ReSharper disable once CppNonExplicitConvertingConstructor
+        constexpr Half(float f) : bits(fromFloat(f)) {
+        }
+
+        // ReSharper disable once CppNonExplicitConversionOperator
+        constexpr operator float() const {
+            return toFloat(bits);
+        }
 
+        static constexpr Half fromBits(uint16_t bits) {
+            Half h;
+            h.bits = bits;
+            return h;
+        }
+
+        friend Half abs(Half h) {
+            return fromBits(static_cast<uint16_t>(h.bits & 0x7fff));
+        }
+
+        friend Half floor(Half h) {
+            return std::floor(static_cast<float>(h));
+        }
+
+        friend Half ceil(Half h) {
+            return std::ceil(static_cast<float>(h));
+        }
+
+        friend Half fmod(Half a, Half b) {
+            return std::fmod(static_cast<float>(a), static_cast<float>(b));
+        }
+
+    private:
+        // Round to nearest even, overflowing to infinity and flushing values below the smallest subnormal to zero.
+        static constexpr uint16_t fromFloat(float f) {
+            uint32_t x = std::bit_cast<uint32_t>(f);
+            uint32_t sign = (x >> 16) & 0x8000;
+            uint32_t mant = x & 0x7fffff;
+            int exp = static_cast<int>((x >> 23) & 0xff) - 127 + 15;
+            if (((x >> 23) & 0xff) == 0xff) return static_cast<uint16_t>(sign | 0x7c00 | (mant ? 0x200 : 0));
+            if (exp >= 31) return static_cast<uint16_t>(sign | 0x7c00);
+            if (exp <= 0) {
+                if (exp < -10) return static_cast<uint16_t>(sign);
+                mant |= 0x800000;
+                int shift = 14 - exp;
+                uint32_t h = mant >> shift;
+                uint32_t rem = mant & ((1u << shift) - 1);
+                uint32_t halfway = 1u << (shift - 1);
+                if (rem > halfway || (rem == halfway && (h & 1))) ++h;
+                return static_cast<uint16_t>(sign | h);
+            }
+            uint32_t h = sign | static_cast<uint32_t>(exp) << 10 | mant >> 13;
+            uint32_t rem = mant & 0x1fff;
+            if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) ++h;
+            return static_cast<uint16_t>(h);
+        }
+
+        static constexpr float toFloat(uint16_t h) {
+            uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+            uint32_t exp = (h >> 10) & 0x1f;
+            uint32_t mant = h & 0x3ff;
+            if (exp == 0x1f) return std::bit_cast<float>(sign | 0x7f800000 | mant << 13);
+            if (exp == 0) {
+                float v = static_cast<float>(mant) * 5.9604644775390625e-8f;
+                return sign ? -v : v;
+            }
+            return std::bit_cast<float>(sign | (exp + 112) << 23 | mant << 13);
+        }
+    };
+
+    inline std::ostream& operator<<(std::ostream& os, Half h) {
+        return os << static_cast<float>(h);
+    }
+
+    // The type reductions over V accumulate in, so that narrow storage does not mean narrow sums.
+    template <typename V>
+    struct accumulator {
+        using type = V;
+    };
+
+    template <>
+    struct accumulator<float> {
+        using type = double;
+    };
+
+    template <>
+    struct accumulator<Half> {
+        using type = double;
+    };
+
+    template <typename V>
+    using accumulator_t = accumulator<V>::type;
+
+    // Value types other than the built-in arithmetic ones provide these functions next to themselves and are
+    // found through argument-dependent lookup.
     namespace math {
         template <typename Q>
         constexpr auto abs(const Q& q) {
-            return Q(std::abs(q.value));
+            using std::abs;
+            return Q(abs(q.value));
         }
 
         template <typename Q>
         constexpr auto fmod(const Q& q1, const Q& q2) {
-            return Q(std::fmod(q1.value, q2.value));
+            using std::fmod;
+            return Q(fmod(q1.value, q2.value));
         }
 
         template <typename Q>
         constexpr auto ceil(const Q& q) {
-            return Q(std::ceil(q.value));
+            using std::ceil;
+            return Q(ceil(q.value));
         }
 
         template <typename Q>
         constexpr auto floor(const Q& q) {
-            return Q(std::floor(q.value));
+            using std::floor;
+            return Q(floor(q.value));
+        }
+
+        // Computes f(q^(Num/Den)'s base value) in the value type, or in float_t for exact value types since those
+        // have no <cmath> overloads.
+        template <int Num, int Den, typename U, typename V, typename F>
+        constexpr auto apply_root(const Quantity<U, V>& q, F f) {
+            using R = pow_t<Quantity<U, V>, Num, Den>;
+            const V v = [&] {
+                if constexpr (pow_result<U, Num, Den>::own) return q.value;
+                else return Quantity<pure_unit_t<U>, V>{q}.value;
+            }();
+
+            if constexpr (is_exact_value_v<V>) return R(static_cast<V>(f(static_cast<float_t>(v))));
+            else return R(static_cast<V>(f(v)));
+        }
+
+        template <typename U, typename V>
+        constexpr auto sqrt(const Quantity<U, V>& q) {
+            return apply_root<1, 2>(q, [](const auto& v) {
+                using std::sqrt;
+                return sqrt(v);
+            });
+        }
+
+        template <typename U, typename V>
+        constexpr auto cbrt(const Quantity<U, V>& q) {
+            return apply_root<1, 3>(q, [](const auto& v) {
+                using std::cbrt;
+                return cbrt(v);
+            });
+        }
+
+        template <int N, typename W>
+        constexpr W pow_by_squaring(const W& base) {
+            if constexpr (N == 0) return W(1);
+            else if constexpr (N == 1) return base;
+            else {
+                W half = pow_by_squaring<N / 2>(base);
+                if constexpr (N % 2 == 0) return half * half;
+                else return half * half * base;
+            }
+        }
+
+        // Integer powers multiply in the value type, so they stay exact for integer and fixed-point quantities.
+        template <int N, typename U, typename V>
+        constexpr auto pow(const Quantity<U, V>& q) {
+            using W = decltype(q.value * q.value);
+            W result = pow_by_squaring<N < 0 ? -N : N>(static_cast<W>(q.value));
+            if constexpr (N < 0) result = W(1) / result;
+            return pow_t<Quantity<U, V>, N>(static_cast<V>(result));
+        }
+
+        template <typename Ratio, typename U, typename V>
+            requires requires { Ratio::num; Ratio::den; }
+        constexpr auto pow(const Quantity<U, V>& q) {
+            constexpr int num = static_cast<int>(Ratio::num);
+            constexpr int den = static_cast<int>(Ratio::den);
+            return apply_root<num, den>(q, [](const auto& v) {
+                using std::pow;
+                return pow(v, static_cast<float_t>(num) / den);
+            });
+        }
+
+        template <typename U1, typename V1, typename U2, typename V2>
+            requires std::is_same_v<pure_unit_t<U1>, pure_unit_t<U2>>
+        constexpr auto hypot(const Quantity<U1, V1>& a, const Quantity<U2, V2>& b) {
+            using std::hypot;
+            V1 y = Quantity<U1, V1>{b}.value;
+            if constexpr (is_exact_value_v<V1>) {
+                return Quantity<U1, V1>(static_cast<V1>(hypot(static_cast<float_t>(a.value), static_cast<float_t>(y))));
+            } else {
+                return Quantity<U1, V1>(static_cast<V1>(hypot(a.value, y)));
+            }
+        }
+
+        template <typename U1, typename V1, typename U2, typename V2, typename U3, typename V3>
+            requires std::is_same_v<pure_unit_t<U1>, pure_unit_t<U2>> && std::is_same_v<pure_unit_t<U1>, pure_unit_t<U3>>
+        constexpr auto hypot(const Quantity<U1, V1>& a, const Quantity<U2, V2>& b, const Quantity<U3, V3>& c) {
+            using std::hypot;
+            V1 y = Quantity<U1, V1>{b}.value;
+            V1 z = Quantity<U1, V1>{c}.value;
+            if constexpr (is_exact_value_v<V1>) {
+                return Quantity<U1, V1>(static_cast<V1>(
+                    hypot(static_cast<float_t>(a.value), static_cast<float_t>(y), static_cast<float_t>(z))
+                ));
+            } else {
+                return Quantity<U1, V1>(static_cast<V1>(hypot(a.value, y, z)));
+            }
+        }
+
+        template <typename In, typename Out, typename F>
+        constexpr void transform_quantities(const In& in, Out& out, F f) {
+            using OutQ = std::ranges::range_value_t<Out>;
+            const auto* src = std::ranges::data(in);
+            auto* dst = std::ranges::data(out);
+            const size_t n = std::ranges::size(in);
+            for (size_t i = 0; i < n; ++i) dst[i] = OutQ(f(src[i]));
+        }
+
+        // Batch versions writing out[i] = f(in[i]) into a range of the result unit, or any unit convertible to it.
+        // The loops are plain element-wise loops that the compiler vectorizes; GCC only vectorizes the sqrt based
+        // ones with -fno-math-errno.
+        template <std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+            requires is_quantity_v<std::ranges::range_value_t<In>>
+        constexpr void sqrt(const In& in, Out&& out) {
+            transform_quantities(in, out, [](const auto& q) { return sqrt(q); });
+        }
+
+        template <std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+            requires is_quantity_v<std::ranges::range_value_t<In>>
+        constexpr void cbrt(const In& in, Out&& out) {
+            transform_quantities(in, out, [](const auto& q) { return cbrt(q); });
+        }
+
+        template <int N, std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+            requires is_quantity_v<std::ranges::range_value_t<In>>
+        constexpr void pow(const In& in, Out&& out) {
+            transform_quantities(in, out, [](const auto& q) { return pow<N>(q); });
+        }
+
+        template <typename Ratio, std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+            requires is_quantity_v<std::ranges::range_value_t<In>> && requires { Ratio::num; Ratio::den; }
+        constexpr void pow(const In& in, Out&& out) {
+            transform_quantities(in, out, [](const auto& q) { return pow<Ratio>(q); });
+        }
+
+        // Unlike the scalar version this is sqrt(x^2 + y^2), without std::hypot's protection against overflow
+        // of the squares, so that it vectorizes.
+        template <std::ranges::contiguous_range InX, std::ranges::contiguous_range InY,
+                  std::ranges::contiguous_range Out>
+            requires is_quantity_v<std::ranges::range_value_t<InX>> && is_quantity_v<std::ranges::range_value_t<InY>>
+        constexpr void hypot(const InX& xs, const InY& ys, Out&& out) {
+            using Q = std::ranges::range_value_t<InX>;
+            using OutQ = std::ranges::range_value_t<Out>;
+            auto y = std::ranges::begin(ys);
+            auto dst = std::ranges::begin(out);
+            for (const auto& x : xs) {
+                Q b{*y++};
+                *dst++ = OutQ(sqrt(x * x + b * b));
+            }
         }
     }
 
@@ -712,8 +1394,8 @@ namespace Unit {
         using exbi = scaled_unit_q<Q, "Ei", std::ratio<1'152'921'504'606'846'976>, E>;
 
 #define __unithpp_literal_(TYPE, SYM) \
-        constexpr auto operator ""_##SYM(long double val) { return TYPE(static_cast<float_t>(val)); } \
-        constexpr auto operator ""_##SYM(unsigned long long val) { return TYPE(static_cast<float_t>(val)); }
+        constexpr auto operator ""_##SYM(long double val) { return TYPE(static_cast<TYPE::value_type>(val)); } \
+        constexpr auto operator ""_##SYM(unsigned long long val) { return TYPE(static_cast<TYPE::value_type>(val)); }
 #define __unithpp_literal(TYPE) __unithpp_literal_(TYPE, TYPE)
 #define __unithpp_scales(UNIT) \
     __unithpp_literal_(atto<UNIT>, a##UNIT) \
@@ -742,6 +1424,70 @@ namespace Unit {
     __unithpp_literal(UNIT) \
     __unithpp_scales(UNIT)
 
+#define __unithpp_all_literals \
+    __unithpp_literals(m) \
+    __unithpp_literals(g) \
+    __unithpp_literals(s) \
+    __unithpp_literals(mol) \
+    __unithpp_literals(K) \
+    __unithpp_literals(A) \
+    __unithpp_literals(cd) \
+    __unithpp_literals(rad) \
+    __unithpp_literals(px) \
+    __unithpp_literals(pwm) \
+    __unithpp_literals(L) \
+    __unithpp_literals(deg) \
+    __unithpp_literals(grad) \
+    __unithpp_literals(mi) \
+    __unithpp_literals(ft) \
+    __unithpp_literals(in) \
+    __unithpp_literals(yd) \
+    __unithpp_literals(oz) \
+    __unithpp_literals(lb) \
+    __unithpp_literals(ton) \
+    __unithpp_literals(gal) \
+    __unithpp_literal(minute) \
+    __unithpp_literal(hour) \
+    __unithpp_literal(day) \
+    __unithpp_literal(week) \
+    __unithpp_literals(Hz) \
+    __unithpp_literals(N) \
+    __unithpp_literals(Pa) \
+    __unithpp_literals(J) \
+    __unithpp_literals(W) \
+    __unithpp_literals(C) \
+    __unithpp_literals(V) \
+    __unithpp_literals(Ohm) \
+    __unithpp_literals(S) \
+    __unithpp_literals(F) \
+    __unithpp_literals(H) \
+    __unithpp_literals(Wb) \
+    __unithpp_literals(Tesla) \
+    __unithpp_literals(sr) \
+    __unithpp_literals(lm) \
+    __unithpp_literals(lx) \
+    __unithpp_literals(Bq) \
+    __unithpp_literals(Gy) \
+    __unithpp_literals(Sv) \
+    __unithpp_literals(Kat) \
+    __unithpp_literals(dyn) \
+    __unithpp_literals(bit) \
+    __unithpp_literals(byte) \
+    __unithpp_literals(bps) \
+    __unithpp_literals(Bps) \
+    constexpr auto operator ""_degC(long double val) { \
+        return K(static_cast<K::value_type>(static_cast<float_t>(val) + 273.15)); \
+    } \
+    constexpr auto operator ""_degC(unsigned long long val) { \
+        return K(static_cast<K::value_type>(static_cast<float_t>(val) + 273.15)); \
+    } \
+    constexpr auto operator ""_degF(long double val) { \
+        return K(static_cast<K::value_type>((static_cast<float_t>(val) - 32) * 5 / 9 + 273.15)); \
+    } \
+    constexpr auto operator ""_degF(unsigned long long val) { \
+        return K(static_cast<K::value_type>((static_cast<float_t>(val) - 32) * 5 / 9 + 273.15)); \
+    }
+
         using m = base_unit_q<"m">;
         using g = base_unit_q<"g">;
         using s = base_unit_q<"s">;
@@ -751,11 +1497,12 @@ namespace Unit {
         using cd = base_unit_q<"cd">;
         using rad = base_unit_q<"rad">;
         using px = Quantity<base_unit<"px">, unsigned>;
+        using bit = base_unit_q<"bit">;
 
         using pwm = compound_unit_q<micro<s>, "pwm">;
         using L = compound_unit_q<deci<m, 3>, "L">;
-        using deg = compound_unit_q<rad, "deg", std::ratio<17453292519943296, 1000000000000000000>>;
-        using grad = compound_unit_q<rad, "grad", std::ratio<15707963267948966, 1000000000000000000>>;
+        using deg = compound_unit_q<rad, "deg", pi_ratio<std::ratio<1, 180>>>;
+        using grad = compound_unit_q<rad, "grad", pi_ratio<std::ratio<1, 200>>>;
         using mi = compound_unit_q<m, "mi", std::ratio<1609344, 1000>>;
         using ft = compound_unit_q<m, "ft", std::ratio<3048, 10000>>;
         using in = compound_unit_q<m, "in", std::ratio<254, 10000>>;
@@ -763,7 +1510,7 @@ namespace Unit {
         using oz = compound_unit_q<g, "oz", std::ratio<28349523125, 1000000000>>;
         using lb = compound_unit_q<g, "lb", std::ratio<45359237, 100>>;
         using ton = compound_unit_q<g, "ton", std::ratio<90718474, 10>>;
-        using gal = compound_unit_q<L, "gal", std::ratio<3785411784, 10000000>>;
+        using gal = compound_unit_q<L, "gal", std::ratio<3785411784, 1000000000>>;
         using minute = compound_unit_q<s, "minute", std::ratio<60>>;
         using hour = compound_unit_q<s, "hour", std::ratio<3600>>;
         using day = compound_unit_q<s, "day", std::ratio<86400>>;
@@ -789,110 +1536,131 @@ namespace Unit {
         using Sv = compound_unit_q<decltype(J{} / kilo<g>{}), "Sv">;
         using Kat = compound_unit_q<decltype(mol{} / s{}), "Kat">;
         using dyn = compound_unit_q<decltype(g{} * m{} / (s{} * s{})), "dyn">;
+        using byte = compound_unit_q<bit, "B", std::ratio<8>>;
+        using bps = compound_unit_q<decltype(bit{} / s{}), "bit/s">;
+        using Bps = compound_unit_q<decltype(byte{} / s{}), "B/s">;
 
-        __unithpp_literals(m)
-        __unithpp_literals(g)
-        __unithpp_literals(s)
-        __unithpp_literals(mol)
-        __unithpp_literals(K)
-        __unithpp_literals(A)
-        __unithpp_literals(cd)
-        __unithpp_literals(rad)
-        __unithpp_literals(px)
-
-        __unithpp_literals(pwm)
-        __unithpp_literals(L)
-        __unithpp_literals(deg)
-        __unithpp_literals(grad)
-        __unithpp_literals(mi)
-        __unithpp_literals(ft)
-        __unithpp_literals(in)
-        __unithpp_literals(yd)
-        __unithpp_literals(oz)
-        __unithpp_literals(lb)
-        __unithpp_literals(ton)
-        __unithpp_literals(gal)
-        __unithpp_literal(minute)
-        __unithpp_literal(hour)
-        __unithpp_literal(day)
-        __unithpp_literal(week)
-        __unithpp_literals(Hz)
-        __unithpp_literals(N)
-        __unithpp_literals(Pa)
-        __unithpp_literals(J)
-        __unithpp_literals(W)
-        __unithpp_literals(C)
-        __unithpp_literals(V)
-        __unithpp_literals(Ohm)
-        __unithpp_literals(S)
-        __unithpp_literals(F)
-        __unithpp_literals(H)
-        __unithpp_literals(Wb)
-        __unithpp_literals(Tesla)
-        __unithpp_literals(sr)
-        __unithpp_literals(lm)
-        __unithpp_literals(lx)
-        __unithpp_literals(Bq)
-        __unithpp_literals(Gy)
-        __unithpp_literals(Sv)
-        __unithpp_literals(Kat)
-        __unithpp_literals(dyn)
+        __unithpp_all_literals
 
-#undef __unithpp_literal
-#undef __unithpp_literals
-#undef __unithpp_scales
+        // Evaluated in the precision of the angle's own value type.
+        template <typename U, typename V> requires requires { with_value_t<rad, V>{std::declval<Quantity<U, V>>()}; }
+        constexpr auto sin(const Quantity<U, V>& q) {
+            using std::sin;
+            return sin(with_value_t<rad, V>{q}.value);
+        }
 
-        constexpr auto operator ""_degC(long double val) {
-            return K(static_cast<float_t>(val) + 273.15);
+        template <typename U, typename V> requires requires { with_value_t<rad, V>{std::declval<Quantity<U, V>>()}; }
+        constexpr auto cos(const Quantity<U, V>& q) {
+            using std::cos;
+            return cos(with_value_t<rad, V>{q}.value);
         }
 
-        constexpr auto operator ""_degC(unsigned long long val) {
-            return K(static_cast<float_t>(val) + 273.15);
+        template <typename U, typename V> requires requires { with_value_t<rad, V>{std::declval<Quantity<U, V>>()}; }
+        constexpr auto tan(const Quantity<U, V>& q) {
+            using std::tan;
+            return tan(with_value_t<rad, V>{q}.value);
         }
 
-        constexpr auto operator ""_degF(long double val) {
-            return K(static_cast<float_t>((val - 32) * 5 / 9 + 273.15));
+        // Inverse functions return angles in rad, evaluated in the precision of the argument. Value types other than
+        // the built-in ones are found through argument-dependent lookup, like in math.
+        template <typename V> requires (!is_quantity_v<V>)
+        constexpr auto asin(V v) {
+            using std::asin;
+            auto r = asin(v);
+            return with_value_t<rad, decltype(r)>{r};
         }
 
-        constexpr auto operator ""_degF(unsigned long long val) {
-            return K((val - 32) * 5 / 9 + 273.15);
+        template <typename V> requires (!is_quantity_v<V>)
+        constexpr auto acos(V v) {
+            using std::acos;
+            auto r = acos(v);
+            return with_value_t<rad, decltype(r)>{r};
         }
 
-        template <typename U> requires requires { rad{std::declval<Quantity<U>>()}; }
-        constexpr auto sin(const Quantity<U>& q) {
-            return std::sin(rad{q}.value);
+        template <typename V> requires (!is_quantity_v<V>)
+        constexpr auto atan(V v) {
+            using std::atan;
+            auto r = atan(v);
+            return with_value_t<rad, decltype(r)>{r};
         }
 
-        template <typename U> requires requires { rad{std::declval<Quantity<U>>()}; }
-        constexpr auto cos(const Quantity<U>& q) {
-            return std::cos(rad{q}.value);
+        template <typename Y, typename X> requires (!is_quantity_v<Y> && !is_quantity_v<X>)
+        constexpr auto atan2(Y y, X x) {
+            using std::atan2;
+            auto r = atan2(y, x);
+            return with_value_t<rad, decltype(r)>{r};
         }
 
-        template <typename U> requires requires { rad{std::declval<Quantity<U>>()}; }
-        constexpr auto tan(const Quantity<U>& q) {
-            return std::tan(rad{q}.value);
+        // Both sides must have the same dimension, x is converted to the unit of y first.
+        template <typename U1, typename V1, typename U2, typename V2>
+            requires std::is_same_v<pure_unit_t<U1>, pure_unit_t<U2>>
+        constexpr auto atan2(const Quantity<U1, V1>& y, const Quantity<U2, V2>& x) {
+            using V = std::conditional_t<is_exact_value_v<V1> || is_exact_value_v<V2>, float_t,
+                                         std::common_type_t<V1, V2>>;
+            return defaults::atan2(static_cast<V>(y.value), Quantity<U1, V>{x}.value);
         }
+
+#undef __unithpp_literal
+#define __unithpp_literal(TYPE) \
+        using TYPE = storage_rebind_t<defaults::TYPE, storage_t>; \
+        __unithpp_literal_(TYPE, TYPE)
+#define __unithpp_storage_namespace \
+        using namespace math; \
+        using defaults::atto, defaults::femto, defaults::pico, defaults::nano, defaults::micro, defaults::milli; \
+        using defaults::centi, defaults::deci, defaults::deca, defaults::hecto, defaults::kilo, defaults::mega; \
+        using defaults::giga, defaults::tera, defaults::peta, defaults::exa; \
+        using defaults::kibi, defaults::mebi, defaults::gibi, defaults::tebi, defaults::pebi, defaults::exbi; \
+        using defaults::sin, defaults::cos, defaults::tan; \
+        using defaults::asin, defaults::acos, defaults::atan, defaults::atan2; \
+        __unithpp_all_literals
+
+        // Every storage namespace instantiates another copy of all unit types, which is expensive to compile, so
+        // they are opt-in: define UNIT_HPP_F32 and/or UNIT_HPP_F16 before including Unit.hpp.
+#ifdef UNIT_HPP_F32
+        // The same units and literals as defaults, stored as float. Use instead of defaults, not next to it.
+        namespace f32 {
+            using storage_t = float;
+            __unithpp_storage_namespace
+        }
+#endif
+
+#ifdef UNIT_HPP_F16
+        // The same units and literals as defaults, stored as Half. Use instead of defaults, not next to it.
+        namespace f16 {
+            using storage_t = Half;
+            __unithpp_storage_namespace
+        }
+#endif
+
+#undef __unithpp_literal
+#undef __unithpp_literals
+#undef __unithpp_scales
+#undef __unithpp_all_literals
+#undef __unithpp_storage_namespace
     }
 
 
     namespace extra_functions {
-        template <typename U>
-        static void sleep(Quantity<U> v) {
+        template <typename U, typename V>
+        static void sleep(Quantity<U, V> v) {
             std::this_thread::sleep_for(std::chrono::nanoseconds{
                 static_cast<long>(defaults::nano<defaults::s>{v}.value)
             });
         }
 
-        static defaults::s get_time() {
-            return defaults::s{
-                defaults::micro<defaults::s>{
-                    static_cast<float>(
-                        std::chrono::duration_cast<std::chrono::microseconds>(
-                            std::chrono::steady_clock::now().time_since_epoch()
-                        ).count()
-                    )
-                }
+        // Monotonic clock reading in integer nanoseconds; differences between readings are exact.
+        static with_value_t<defaults::nano<defaults::s>, int64_t> get_time_ns() {
+            return with_value_t<defaults::nano<defaults::s>, int64_t>{
+                static_cast<int64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()
+                    ).count()
+                )
             };
         }
+
+        static defaults::s get_time() {
+            return defaults::s{get_time_ns()};
+        }
     }
 }
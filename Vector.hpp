@@ -20,7 +20,7 @@ template <size_t N, typename T>
 struct Vector {
     std::array<T, N> components;
 
-    constexpr Vector() : components{} {
+    constexpr Vector() : components() {
     }
 
     template <typename... Args>
@@ -135,7 +135,8 @@ struct Vector {
     }
 
     constexpr auto dot(const Vector& other) const {
-        T sum = T{0};
+        using Product = decltype(components[0] * other[0]);
+        Product sum = Product(0);
         for (size_t i = 0; i < N; ++i) sum += components[i] * other[i];
         return sum;
     }
@@ -157,10 +158,11 @@ struct Vector {
     }
 
     constexpr auto length() const {
-        if constexpr (requires { std::sqrt(lengthSquared()); }) {
-            return std::sqrt(lengthSquared());
+        if constexpr (Unit::is_quantity_v<T>) {
+            return T{Unit::math::sqrt(lengthSquared())};
         } else {
-            return T{std::sqrt(static_cast<double>(lengthSquared()))};
+            using std::sqrt;
+            return sqrt(lengthSquared());
         }
     }
 
@@ -169,14 +171,18 @@ struct Vector {
     }
 
     constexpr auto angleTo(const Vector& other) const {
-        auto den = std::sqrt(lengthSquared() * other.lengthSquared());
-        if (den < 1e-9) return Unit::defaults::rad{0};
-
-        auto val = dot(other) / den;
+        auto den = length() * other.length();
+        using Ratio = Unit::dimensionless_value_t<decltype(dot(other) / den)>;
+        using Angle = Unit::with_value_t<Unit::defaults::rad, decltype(Unit::defaults::acos(Ratio{}).value)>;
+        // Below 1e-9 (in the unit of den) the direction is mostly rounding error, so the angle is taken as 0.
+        // den == 0 is checked separately because 1e-9 converts to 0 for integer lengths.
+        if (den == decltype(den)(0) || den < decltype(den)(1e-9)) return Angle(0);
+
+        auto val = static_cast<Ratio>(dot(other) / den);
         if (val > 1.0) val = 1.0;
         if (val < -1.0) val = -1.0;
 
-        return Unit::defaults::rad{std::acos(val)};
+        return Angle{Unit::defaults::acos(val)};
     }
 
     constexpr auto projectedOnto(const Vector& axis) const {
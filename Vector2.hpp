@@ -100,10 +100,10 @@ struct Vector2 {
     }
 
     constexpr auto length() const {
-        if constexpr (requires { sqrt(lengthSquared()); }) {
-            return sqrt(lengthSquared());
+        if constexpr (Unit::is_quantity_v<T>) {
+            return T{Unit::math::sqrt(lengthSquared())};
         } else {
-            return T{sqrt(static_cast<double>(lengthSquared()))};
+            return sqrt(lengthSquared());
         }
     }
 
@@ -116,11 +116,11 @@ struct Vector2 {
     }
 
     constexpr auto angleTo(const Vector2& other) const {
-        return Unit::defaults::rad{atan2(other.y - y, other.x - x)};
+        return Unit::defaults::atan2(other.y - y, other.x - x);
     }
 
     constexpr auto angle() const {
-        return Unit::defaults::rad{atan2(y, x)};
+        return Unit::defaults::atan2(y, x);
     }
 
     constexpr Vector2 rotatedBy(auto phi) const {
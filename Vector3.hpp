@@ -105,10 +105,10 @@ struct Vector3 {
     }
 
     constexpr auto length() const {
-        if constexpr (requires { sqrt(lengthSquared()); }) {
-            return sqrt(lengthSquared());
+        if constexpr (Unit::is_quantity_v<T>) {
+            return T{Unit::math::sqrt(lengthSquared())};
         } else {
-            return T{sqrt(static_cast<double>(lengthSquared()))};
+            return sqrt(lengthSquared());
         }
     }
 
@@ -122,13 +122,15 @@ struct Vector3 {
 
     constexpr auto angleTo(const Vector3& other) const {
         auto den = length() * other.length();
-        if (den == 0) return Unit::defaults::rad{0};
+        using Ratio = Unit::dimensionless_value_t<decltype(dot(other) / den)>;
+        using Angle = Unit::with_value_t<Unit::defaults::rad, decltype(Unit::defaults::acos(Ratio{}).value)>;
+        if (den == decltype(den)(0)) return Angle(0);
 
-        auto val = dot(other) / den;
+        auto val = static_cast<Ratio>(dot(other) / den);
         if (val > 1.0) val = 1.0;
         if (val < -1.0) val = -1.0;
 
-        return Unit::defaults::rad{acos(val)};
+        return Angle{Unit::defaults::acos(val)};
     }
 
     constexpr Vector3 rotatedBy(auto angle, const Vector3& axis) const {
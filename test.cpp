@@ -1,4 +1,35 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <random>
+#include <vector>
+
+#include "Algorithm.hpp"
+#include "Atomic.hpp"
+#include "BVH.hpp"
+#include "Dual.hpp"
+#include "Histogram.hpp"
+#include "Interval.hpp"
+#include "LookupTable.hpp"
+#include "Matrix.hpp"
+#include "Ode.hpp"
+#include "Fixed.hpp"
+#include "Quadtree.hpp"
+#include "Queue.hpp"
+#include "Rate.hpp"
+#include "RectList.hpp"
+#include "Reduce.hpp"
+#include "ScaledView.hpp"
+#include "Stats.hpp"
+#include "Trig.hpp"
+#include "Uncertain.hpp"
+#include "Vector.hpp"
+#include "Vector3.hpp"
+#include "RectGrid.hpp"
 #include "Unit.hpp"
 
 // Bring all literals (_m, _s, _N, etc.) into scope
@@ -9,7 +40,1115 @@ void print_header(const char* title) {
     std::cout << "\n================ " << title << " ================\n";
 }
 
+// Checks for the tests after the demo. A failed check is reported and makes main return 1, which ctest picks up.
+int failures = 0;
+
+void check(bool ok, const char* expr, const char* file, int line) {
+    if (ok) return;
+    ++failures;
+    std::cerr << file << ":" << line << ": check failed: " << expr << "\n";
+}
+
+#define CHECK(...) check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+#define CHECK_NEAR(...) check_near(__VA_ARGS__, #__VA_ARGS__, __FILE__, __LINE__)
+
+void check_near(double a, double b, double tolerance, const char* args, const char* file, int line) {
+    check(std::abs(a - b) <= tolerance, args, file, line);
+}
+
+template <typename F>
+bool throws_overflow(F f) {
+    try {
+        f();
+    } catch (const std::overflow_error&) {
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+std::vector<T> sorted(std::vector<T> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// Inserts, removes and moves random rects in an index and compares its queries with a scan over the live rects.
+template <typename Index>
+void test_rect_index(Index index) {
+    std::mt19937 rng(26);
+    std::uniform_real_distribution<double> pos(0, 100), size(0.5, 8);
+    auto random_rect = [&] { return Rect<double>(pos(rng), pos(rng), size(rng), size(rng)); };
+
+    std::vector<Rect<double>> rects;
+    std::vector<bool> live;
+    for (int i = 0; i < 300; ++i) {
+        auto id = index.insert(random_rect());
+        rects.resize(std::max(rects.size(), id + 1));
+        live.resize(rects.size());
+        rects[id] = index[id];
+        live[id] = true;
+    }
+    for (size_t id = 0; id < rects.size(); id += 3) {
+        CHECK(index.remove(id));
+        live[id] = false;
+    }
+    for (size_t id = 1; id < rects.size(); id += 5) {
+        if (!live[id]) continue;
+        rects[id] = random_rect();
+        CHECK(index.move(id, rects[id]));
+    }
+    // Dead and out-of-range ids are rejected without touching the index.
+    const size_t count = index.size();
+    CHECK(!index.remove(0) && !index.move(3, random_rect()) && !index.remove(rects.size() + 7));
+    CHECK(index.size() == count);
+    // Freed ids are reused, once each.
+    const auto reused = index.insert(random_rect()), next = index.insert(random_rect());
+    CHECK(reused % 3 == 0 && next % 3 == 0 && reused != next && index.size() == count + 2);
+    index.remove(reused);
+    index.remove(next);
+
+    for (int q = 0; q < 50; ++q) {
+        Rect<double> range = random_rect();
+        range.width = range.width * 3;
+        Vector2<double> point(pos(rng), pos(rng));
+        std::vector<size_t> inRange, atPoint;
+        for (size_t id = 0; id < rects.size(); ++id) {
+            if (!live[id]) continue;
+            if (rects[id].intersects(range)) inRange.push_back(id);
+            if (rects[id].contains(point)) atPoint.push_back(id);
+        }
+        CHECK(sorted(index.queryRange(range)) == inRange);
+        CHECK(sorted(index.queryPoint(point)) == atPoint);
+    }
+}
+
+// Builds a BVH over random boxes (large enough for the parallel SAH build) and compares overlap and ray queries with
+// a scan over the boxes, before and after a refit.
+void test_bvh() {
+    std::mt19937 rng(27);
+    std::uniform_real_distribution<double> pos(-50, 50), size(0.1, 3);
+    auto random_point = [&] { return Vector3<m>{m(pos(rng)), m(pos(rng)), m(pos(rng))}; };
+    auto random_box = [&] {
+        auto p = random_point();
+        return AABB<m>{p, p + Vector3<m>{m(size(rng)), m(size(rng)), m(size(rng))}};
+    };
+
+    std::vector<AABB<m>> boxes(6000);
+    for (auto& box : boxes) box = random_box();
+    BVH<m> bvh(boxes, 4);
+
+    // Subtrees built on the pool are spliced into the same layout as a serial build.
+    BVH<m> serial(boxes, 1);
+    CHECK(serial.nodes.size() == bvh.nodes.size() && serial.indices == bvh.indices);
+    CHECK(std::equal(serial.nodes.begin(), serial.nodes.end(), bvh.nodes.begin(), [](const auto& a, const auto& b) {
+        return a.offset == b.offset && a.count == b.count && a.axis == b.axis;
+    }));
+
+    auto check_queries = [&] {
+        for (int q = 0; q < 40; ++q) {
+            AABB<m> query = random_box();
+            query.max = query.max + Vector3<m>{5.0_m, 5.0_m, 5.0_m};
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < boxes.size(); ++i) {
+                if (boxes[i].intersects(query)) expected.push_back(i);
+            }
+            CHECK(sorted(bvh.queryOverlap(query)) == expected);
+
+            auto dir = Vector3<double>{pos(rng), pos(rng), pos(rng)};
+            dir = dir / std::sqrt(dir.x * dir.x + dir.y * dir.y + dir.z * dir.z);
+            Ray<m> ray(random_point(), dir);
+            std::optional<m> nearest;
+            for (const auto& box : boxes) {
+                auto t = ray.intersect(box, 200.0_m);
+                if (t && (!nearest || *t < *nearest)) nearest = t;
+            }
+            auto hit = bvh.closestHit(ray, 200.0_m, [&](uint32_t i, const Ray<m>& r, m tMax) {
+                return r.intersect(boxes[i], tMax);
+            });
+            CHECK(hit.has_value() == nearest.has_value());
+            if (hit && nearest) CHECK(hit->second == *nearest);
+        }
+    };
+    check_queries();
+    for (auto& box : boxes) {
+        auto shift = Vector3<m>{m(pos(rng) / 10), m(pos(rng) / 10), m(pos(rng) / 10)};
+        box = AABB<m>{box.min + shift, box.max + shift};
+    }
+    bvh.refit(boxes);
+    check_queries();
+
+    // Empty boxes grow from the extreme values of integer and fixed-point coordinates as well.
+    AABB<int> ints;
+    CHECK(ints.empty());
+    ints.expand(Vector3<int>{1, -2, 3});
+    CHECK(ints == AABB<int>::fromPoint(Vector3<int>{1, -2, 3}));
+    using Q16 = Unit::Fixed<int32_t, 16>;
+    AABB<Q16> fixed;
+    CHECK(fixed.empty());
+    fixed.expand(Vector3<Q16>{Q16(1.5), Q16(-2), Q16(0)});
+    CHECK(!fixed.empty() && fixed.min.x == Q16(1.5) && fixed.max.y == Q16(-2));
+    AABB<unsigned> unsignedBox;
+    unsignedBox.expand(Vector3<unsigned>{0, 0, 0});
+    CHECK(unsignedBox == AABB<unsigned>::fromPoint(Vector3<unsigned>{0, 0, 0}));
+    AABB<px> pixels;
+    CHECK(pixels.empty());
+    pixels.expand(Vector3<px>{px(0), px(7), px(0)});
+    pixels.expand(Vector3<px>{px(3), px(2), px(0)});
+    CHECK(pixels.min.y.value == 2 && pixels.max.x.value == 3 && pixels.max.y.value == 7 && pixels.max.z.value == 0);
+}
+
+// The batch tests of RectList against the scalar Rect predicates, at sizes that leave a partial last mask word.
+void test_rect_list() {
+    std::mt19937 rng(28);
+    std::uniform_real_distribution<double> pos(0, 20), size(0.5, 6);
+    auto random_rect = [&] { return Rect<m>(m(pos(rng)), m(pos(rng)), m(size(rng)), m(size(rng))); };
+    for (size_t n : {1, 63, 64, 65, 130, 1000}) {
+        std::vector<Rect<m>> rects(n);
+        for (auto& rect : rects) rect = random_rect();
+        RectList<m> list(rects);
+        for (int q = 0; q < 10; ++q) {
+            const auto range = random_rect();
+            const auto inner = Rect<m>(range.x, range.y, range.width / 4, range.height / 4);
+            const Vector2<m> point(m(pos(rng)), m(pos(rng)));
+            auto hits = list.intersects(range), holders = list.contains(point), covers = list.contains(inner);
+            CHECK(hits.size() == RectList<m>::maskWords(n));
+            std::vector<uint32_t> expectHits, expectHolders, expectCovers;
+            for (uint32_t i = 0; i < n; ++i) {
+                if (rects[i].intersects(range)) expectHits.push_back(i);
+                if (rects[i].contains(point)) expectHolders.push_back(i);
+                if (rects[i].contains(inner)) expectCovers.push_back(i);
+            }
+            CHECK(RectList<m>::compact(hits) == expectHits);
+            CHECK(RectList<m>::compact(holders) == expectHolders);
+            CHECK(RectList<m>::compact(covers) == expectCovers);
+            CHECK(RectList<m>::count(hits) == expectHits.size());
+
+            auto clipped = list.intersection(range);
+            for (size_t i = 0; i < n; ++i) {
+                auto expected = rects[i].intersection(range);
+                CHECK(clipped[i].x == expected.x && clipped[i].width == expected.width);
+            }
+        }
+    }
+}
+
+// Integer and fixed-point conversions: exact, truncated toward zero, and throwing when the result does not fit.
+void test_exact_conversions() {
+    using ns = Unit::with_value_t<nano<s>, int64_t>;
+    using ms = Unit::with_value_t<milli<s>, int64_t>;
+    using us = Unit::with_value_t<micro<s>, int64_t>;
+    using whole_s = Unit::with_value_t<s, int64_t>;
+    using ms32 = Unit::with_value_t<milli<s>, int32_t>;
+    using us32 = Unit::with_value_t<micro<s>, int32_t>;
+
+    CHECK(ns{ms{1500}}.value == 1'500'000'000);
+    CHECK(ms{ns{1'999'999}}.value == 1);
+    CHECK(ms{ns{-1'999'999}}.value == -1);
+    CHECK(ms{ns{INT64_MIN}}.value == INT64_MIN / 1'000'000);
+    CHECK(us{ms32{INT32_MIN}}.value == int64_t{INT32_MIN} * 1000);
+    CHECK(ms32{ns{int64_t{INT32_MIN} * 1'000'000}}.value == INT32_MIN);
+    CHECK(throws_overflow([] { return ns{whole_s{INT64_MAX / 1000}}; }));
+    CHECK(throws_overflow([] { return ns{whole_s{INT64_MIN}}; }));
+    CHECK(throws_overflow([] { return us32{ms32{INT32_MIN}}; }));
+    CHECK(throws_overflow([] { return ms32{ns{(int64_t{INT32_MIN} - 1) * 1'000'000}}; }));
+
+    using Unit::Q16_16;
+    for (double v : {0.0, 1.0, -2.25, 1.0 / 65536, 32767.5, -32768.0}) CHECK(static_cast<double>(Q16_16(v)) == v);
+    CHECK(Q16_16(1.5) * Q16_16(2) == Q16_16(3) && Q16_16(3) / Q16_16(2) == Q16_16(1.5));
+    Unit::with_value_t<m, Q16_16> x{Q16_16(1.5)};
+    Unit::with_value_t<milli<m>, Q16_16> x_mm{x};
+    CHECK(x_mm.value == Q16_16(1500));
+    CHECK(Unit::with_value_t<m, Q16_16>{x_mm}.value == Q16_16(1.5));
+    CHECK(Unit::with_value_t<kilo<m>, Q16_16>{x}.value.raw == 98); // 0.0015 * 2^16 = 98.3, truncated
+    CHECK(throws_overflow([] {
+        return Unit::with_value_t<milli<m>, Q16_16>{Unit::with_value_t<m, Q16_16>{Q16_16(40)}};
+    }));
+}
+
+// Roots and powers keep the unit's own scale where the exponents allow it and check the dimension at compile time.
+void test_roots_and_powers() {
+    auto side = Unit::math::sqrt(16.0_km * 1.0_km);
+    static_assert(std::is_same_v<decltype(side), kilo<m>>);
+    CHECK(side.value == 4.0);
+    auto edge = Unit::math::cbrt(8.0_m * 1.0_m * 1.0_m);
+    static_assert(std::is_same_v<decltype(edge), m>);
+    CHECK_NEAR(edge.value, 2.0, 1e-15);
+    CHECK_NEAR(m(Unit::math::cbrt(8.0_L)).value, 0.2, 1e-15); // L is not a cube, so via m^3
+    auto area = Unit::math::pow<2>(3.0_km);
+    static_assert(std::is_same_v<decltype(area), decltype(1.0_km * 1.0_km)>);
+    CHECK(area.value == 9.0);
+    CHECK(Unit::math::pow<-1>(2.0_s).value == 0.5);
+    CHECK(std::is_same_v<decltype(Unit::math::pow<-1>(2.0_s) * 1.0_s), double>);
+    auto volume = Unit::math::pow<std::ratio<3, 2>>(4.0_km * 1.0_km);
+    static_assert(std::is_same_v<decltype(volume), decltype(1.0_km * 1.0_km * 1.0_km)>);
+    CHECK_NEAR(volume.value, 8.0, 1e-12);
+    CHECK(Unit::math::pow<3>(Unit::with_value_t<m, int>(3)).value == 27);
+    auto d = Unit::math::hypot(3.0_m, 400.0_cm);
+    static_assert(std::is_same_v<decltype(d), m>);
+    CHECK_NEAR(d.value, 5.0, 1e-15);
+    CHECK_NEAR(Unit::math::hypot(2.0_m, 300.0_cm, 6000.0_mm).value, 7.0, 1e-15);
+
+    // The batch overloads convert into the unit of the output range.
+    std::vector<decltype(1.0_km * 1.0_km)> areas{4.0_km * 1.0_km, 2.25_km * 1.0_km};
+    std::vector<m> sides(areas.size());
+    Unit::math::sqrt(areas, sides);
+    CHECK_NEAR(sides[0].value, 2000.0, 1e-9);
+    CHECK_NEAR(sides[1].value, 1500.0, 1e-9);
+    std::vector<decltype(1.0_m * 1.0_m * 1.0_m)> volumes{27.0_m * 1.0_m * 1.0_m};
+    std::vector<centi<m>> edges(1);
+    Unit::math::cbrt(volumes, edges);
+    CHECK_NEAR(edges[0].value, 300.0, 1e-9);
+    std::vector<decltype(1.0_m * 1.0_m)> squares(2);
+    Unit::math::pow<2>(sides, squares);
+    CHECK_NEAR(squares[1].value, 2.25e6, 1e-6);
+    std::vector<decltype(1.0_km * 1.0_km * 1.0_km)> cubes(2);
+    Unit::math::pow<std::ratio<3, 2>>(areas, cubes);
+    CHECK_NEAR(cubes[0].value, 8.0, 1e-12);
+    std::vector<m> xs{3.0_m, 5.0_m}, diagonals(2);
+    std::vector<centi<m>> ys{400.0_cm, 1200.0_cm};
+    Unit::math::hypot(xs, ys, diagonals);
+    CHECK_NEAR(diagonals[0].value, 5.0, 1e-12);
+    CHECK_NEAR(diagonals[1].value, 13.0, 1e-12);
+}
+
+// Error of the batch trigonometry tiers against long double references: ulps of the result on rad, absolute error on
+// deg and grad, whose reduction is exact.
+void test_batch_trig() {
+    using Unit::Accuracy;
+    const long double pi_l = 3.141592653589793238462643383279502884L;
+    const auto ulps = [](double got, long double ref) {
+        const double r = std::abs(static_cast<double>(ref));
+        return static_cast<double>(std::abs(got - ref) / (std::nextafter(r, INFINITY) - r));
+    };
+    std::mt19937 rng(32);
+
+    std::uniform_real_distribution<double> radians(-100, 100);
+    std::vector<rad> r(20000);
+    for (auto& x : r) x = rad(radians(rng));
+    std::vector<double> s(r.size()), c(r.size()), fast(r.size()), exact(r.size());
+    Unit::math::sincos(r, s, c);
+    Unit::math::sin<Accuracy::Fast>(r, fast);
+    Unit::math::sin<Accuracy::Exact>(r, exact);
+    double worstUlp = 0, worstFast = 0;
+    bool exactMatches = true;
+    for (size_t i = 0; i < r.size(); ++i) {
+        worstUlp = std::max({worstUlp, ulps(s[i], sinl(r[i].value)), ulps(c[i], cosl(r[i].value))});
+        worstFast = std::max(worstFast, static_cast<double>(std::abs(fast[i] - sinl(r[i].value))));
+        exactMatches = exactMatches && exact[i] == std::sin(r[i].value);
+    }
+    CHECK(worstUlp < 2.5);
+    CHECK(worstFast < 2.5e-8);
+    CHECK(exactMatches);
+
+    // Arguments beyond the reduction range, including inf and nan, go through std::sin and std::cos.
+    const std::vector<rad> extreme{rad(1e300), rad(-4e6), rad(INFINITY), rad(NAN), rad(-INFINITY)};
+    std::vector<double> es(extreme.size()), ec(extreme.size());
+    Unit::math::sincos(extreme, es, ec);
+    CHECK(es[0] == std::sin(1e300) && ec[0] == std::cos(1e300));
+    CHECK(es[1] == std::sin(-4e6) && ec[1] == std::cos(-4e6));
+    CHECK(std::isnan(es[2]) && std::isnan(ec[3]) && std::isnan(es[4]));
+
+    std::uniform_real_distribution<double> turns(-100, 100);
+    std::vector<deg> d(20000);
+    std::vector<grad> g(20000);
+    for (auto& x : d) x = deg(turns(rng) * 360);
+    for (auto& x : g) x = grad(turns(rng) * 400);
+    std::vector<double> ds(d.size()), dc(d.size()), gs(g.size());
+    Unit::math::sincos(d, ds, dc);
+    Unit::math::sin(g, gs);
+    double worstDeg = 0, worstGrad = 0;
+    for (size_t i = 0; i < d.size(); ++i) {
+        const long double x = fmodl(d[i].value, 360) * pi_l / 180;
+        worstDeg = std::max({worstDeg, static_cast<double>(std::abs(ds[i] - sinl(x))),
+                             static_cast<double>(std::abs(dc[i] - cosl(x)))});
+        const long double y = fmodl(g[i].value, 400) * pi_l / 200;
+        worstGrad = std::max(worstGrad, static_cast<double>(std::abs(gs[i] - sinl(y))));
+    }
+    CHECK(worstDeg < 2e-16);
+    CHECK(worstGrad < 2e-16);
+
+    // Multiples of a quarter turn come out exact.
+    std::vector<deg> quarters{0.0_deg, 90.0_deg, 180.0_deg, -90.0_deg, 36000.0_deg};
+    std::vector<double> qs(quarters.size()), qc(quarters.size());
+    Unit::math::sincos(quarters, qs, qc);
+    CHECK(qs == std::vector<double>{0, 1, 0, -1, 0});
+    CHECK(qc == std::vector<double>{1, 0, -1, 0, 1});
+
+    // Arguments beyond the reduction range fall back to std::sin, and so do infinities and nans.
+    std::vector<rad> large{rad(1e7), rad(-3e9), rad(INFINITY), rad(NAN)};
+    std::vector<double> ls(large.size());
+    Unit::math::sin(large, ls);
+    CHECK(ls[0] == std::sin(1e7) && ls[1] == std::sin(-3e9) && std::isnan(ls[2]) && std::isnan(ls[3]));
+}
+
+// Inverse trig returns rad, and angleTo treats near-zero vectors as having no direction.
+void test_inverse_trig() {
+    static_assert(std::is_same_v<decltype(Unit::defaults::acos(0.5)), rad>);
+    CHECK_NEAR(deg(Unit::defaults::acos(0.5)).value, 60.0, 1e-12);
+    CHECK_NEAR(deg(Unit::defaults::atan2(1.0_m, 100.0_cm)).value, 45.0, 1e-12);
+
+    using V2 = Vector<2, m>;
+    CHECK_NEAR(V2(1.0_m, 0.0_m).angleTo(V2(0.0_m, 2.0_m)).value, Unit::pi / 2, 1e-15);
+    CHECK_NEAR(V2(1.0_m, 1.0_m).angleTo(V2(-3.0_m, -3.0_m)).value, Unit::pi, 1e-7);
+    CHECK(V2(1e-6_m, 0.0_m).angleTo(V2(0.0_m, 1e-6_m)).value == 0);
+    CHECK(V2(0.0_m, 0.0_m).angleTo(V2(1.0_m, 0.0_m)).value == 0);
+    CHECK(Vector<2, int>(0, 0).angleTo(Vector<2, int>(1, 0)).value == 0);
+    CHECK_NEAR(Vector<2, int>(1, 0).angleTo(Vector<2, int>(0, 1)).value, Unit::pi / 2, 1e-15);
+}
+
+// Reductions large enough to be split into chunks, against their serial results.
+void test_reductions() {
+    std::mt19937 rng(34);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    const size_t n = 3 * Unit::default_pool().grain() + 123;
+    std::vector<m> lengths(n);
+    std::vector<N> forces(n);
+    for (auto& l : lengths) l = m(dist(rng));
+    for (auto& f : forces) f = N(dist(rng));
+
+    double serial = 0;
+    for (const auto& l : lengths) serial += l.value;
+    auto total = Unit::sum(lengths, 1);
+    CHECK(Unit::sum(lengths, 4).value == total.value && Unit::sum(lengths).value == total.value);
+    CHECK_NEAR(total.value, serial, 1e-9);
+    CHECK_NEAR(Unit::mean(lengths).value, serial / n, 1e-12);
+    auto work = Unit::dot(forces, lengths, 1);
+    CHECK(J(Unit::dot(forces, lengths, 4)).value == J(work).value);
+
+    // Folds into the element type, into another unit, and into something else entirely (serially).
+    auto longest = Unit::reduce(lengths, lengths[0], [](m a, m b) { return a > b ? a : b; });
+    CHECK(longest == *std::max_element(lengths.begin(), lengths.end()));
+    CHECK(Unit::reduce(lengths, longest, [](m a, m b) { return a > b ? a : b; }, 1) == longest);
+    auto km_total = Unit::reduce(lengths, kilo<m>(0), [](kilo<m> a, const auto& b) { return a + kilo<m>(b); }, 4);
+    CHECK_NEAR(km_total.value, serial / 1000, 1e-12);
+    auto positives = Unit::reduce(lengths, size_t{0}, [](size_t count, const m& l) {
+        return count + (l.value > 0);
+    });
+    CHECK(positives == static_cast<size_t>(std::count_if(lengths.begin(), lengths.end(), [](m l) {
+        return l.value > 0;
+    })));
+}
+
+// Stats and TDigest merged from several parts, against the statistics of all values.
+void test_stats() {
+    std::mt19937 rng(35);
+    std::normal_distribution<double> dist(10, 2);
+    std::vector<double> all;
+    std::vector<m> block(5000);
+    Unit::Stats<m> serial, first, second;
+    Unit::TDigest<m> flushed, unflushed, empty;
+    for (int i = 0; i < 50000; ++i) {
+        const double v = dist(rng);
+        all.push_back(v);
+        serial.add(m(v));
+        first.add(m(v));
+        flushed.add(m(v));
+    }
+    for (auto& q : block) {
+        q = m(dist(rng));
+        all.push_back(q.value);
+        serial.add(q);
+        unflushed.add(q);
+    }
+    second.add(block);
+    flushed.flush();
+
+    first.merge(second);
+    CHECK(first.count() == all.size() && serial.count() == all.size());
+    CHECK_NEAR(first.mean().value, serial.mean().value, 1e-12);
+    CHECK_NEAR(first.variance().value, serial.variance().value, 1e-9);
+    CHECK_NEAR(first.stddev().value, 2.0, 0.05);
+
+    // Merging empty digests, into empty and into flushed ones, changes nothing; then unflushed buffers are merged.
+    Unit::TDigest<m> merged;
+    merged.merge(empty);
+    CHECK(merged.count() == 0 && std::isnan(merged.quantile(0.5).value));
+    merged.merge(flushed);
+    merged.merge(empty);
+    CHECK(merged.count() == 50000);
+    merged.merge(unflushed);
+    std::sort(all.begin(), all.end());
+    CHECK(merged.count() == static_cast<double>(all.size()));
+    CHECK(merged.min().value == all.front() && merged.max().value == all.back());
+    // Quantile errors measured in rank, where the digest's accuracy is bounded.
+    auto rank = [&](double v) {
+        return static_cast<double>(std::lower_bound(all.begin(), all.end(), v) - all.begin()) / all.size();
+    };
+    for (double p : {0.001, 0.01, 0.25, 0.5, 0.75, 0.99, 0.999}) {
+        CHECK(std::abs(rank(merged.quantile(p).value) - p) < 1e-3);
+    }
+}
+
+// Histogram percentiles within the bucket resolution, and sharded recording from several threads.
+void test_histograms() {
+    using us = Unit::with_value_t<micro<s>, int64_t>;
+    using ns = Unit::with_value_t<nano<s>, int64_t>;
+    std::mt19937 rng(36);
+    std::uniform_int_distribution<int64_t> dist(1, 1'000'000);
+    std::vector<int64_t> values(20000);
+    for (auto& v : values) v = dist(rng);
+
+    Unit::Histogram<us> first, second;
+    for (size_t i = 0; i < values.size(); ++i) (i % 2 ? first : second).record(us(values[i]));
+    first.merge(second);
+    std::sort(values.begin(), values.end());
+    CHECK(first.count() == values.size());
+    CHECK(first.min().value == values.front() && first.max().value == values.back());
+    for (double p : {1.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+        const auto exact = values[static_cast<size_t>(std::ceil(p / 100 * values.size())) - 1];
+        const auto reported = first.percentile(p).value;
+        CHECK(reported >= exact && reported - exact <= exact / 64);
+    }
+    CHECK_NEAR(first.mean().value, Unit::mean(std::vector<us>(values.begin(), values.end())).value, 500.0);
+
+    // Other units are converted exactly, truncating; negative values count as 0.
+    Unit::Histogram<us> converted;
+    converted.record(ns(1999));
+    converted.record(ns(-5));
+    CHECK(converted.max().value == 1 && converted.min().value == 0 && converted.count() == 2);
+    converted.reset();
+    CHECK(converted.count() == 0 && converted.percentile(50).value == 0);
+
+    Unit::ShardedHistogram<us> sharded(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < values.size(); i += 4) sharded.record(us(values[i]));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    auto snapshot = sharded.snapshot();
+    CHECK(snapshot.count() == values.size());
+    CHECK(snapshot.min().value == values.front() && snapshot.max().value == values.back());
+    bool sameBuckets = true;
+    for (size_t i = 0; i < Unit::Histogram<us>::bucketCount; ++i) {
+        sameBuckets = sameBuckets && snapshot.bucket(i) == first.bucket(i);
+    }
+    CHECK(sameBuckets);
+
+    Unit::Histogram<ns> timings;
+    {
+        Unit::ScopedTimer timer(timings);
+    }
+    CHECK(timings.count() == 1);
+}
+
+// Tables of a quadratic, which linear interpolation matches at the knots and cubic interpolation everywhere.
+void test_lookup_tables() {
+    using Unit::Interpolation;
+    using Table = Unit::LookupTable<s, m>;
+    const auto fall = [](s t) { return m(4.9 * t.value * t.value); };
+
+    // Non-uniform points given in other units: ms in, km out.
+    std::vector<milli<s>> xs{0.0_ms, 500.0_ms, 1200.0_ms, 2000.0_ms, 3500.0_ms, 5000.0_ms};
+    std::vector<kilo<m>> ys;
+    for (auto x : xs) ys.push_back(kilo<m>(fall(s(x))));
+    Table linear(xs, ys), cubic(xs, ys, Interpolation::Cubic);
+    auto uniform = Table::sample(0.0_s, 5.0_s, 11, fall);
+    auto uniformCubic = Table::sample(0.0_s, 5.0_s, 11, fall, Interpolation::Cubic);
+    CHECK(linear.size() == 6 && uniform.size() == 11 && uniform.min() == 0.0_s && uniform.max() == 5.0_s);
+
+    for (double t : {0.0, 0.25, 0.5, 1.0, 1.7, 2.0, 3.1, 4.75, 5.0}) {
+        const double exact = fall(s(t)).value;
+        CHECK_NEAR(cubic(s(t)).value, exact, 1e-9);
+        CHECK_NEAR(uniformCubic(s(t)).value, exact, 1e-9);
+        CHECK(linear(s(t)).value >= exact - 1e-9 && uniform(s(t)).value >= exact - 1e-9); // chords lie above
+    }
+    CHECK_NEAR(linear(1200.0_ms).value, fall(1.2_s).value, 1e-9);
+    CHECK_NEAR(uniform(1.5_s).value, fall(1.5_s).value, 1e-9);
+    CHECK_NEAR(linear(1.6_s).value, (fall(1.2_s).value + fall(2.0_s).value) / 2, 1e-9);
+    CHECK_NEAR(uniform(1.25_s).value, (fall(1.0_s).value + fall(1.5_s).value) / 2, 1e-9);
+    CHECK(linear(-1.0_s).value == 0 && cubic(9.0_s) == cubic(5.0_s) && uniform(1.0_hour) == uniform(5.0_s));
+
+    // The batch overloads convert both ends and agree with the scalar lookups.
+    std::vector<milli<s>> times{0.0_ms, 333.0_ms, 1700.0_ms, 4999.0_ms, 7000.0_ms};
+    std::vector<kilo<m>> heights(times.size()), uniformHeights(times.size());
+    cubic(times, heights);
+    uniformCubic(times, uniformHeights);
+    for (size_t i = 0; i < times.size(); ++i) {
+        CHECK_NEAR(heights[i].value, kilo<m>(cubic(times[i])).value, 1e-12);
+        CHECK_NEAR(uniformHeights[i].value, kilo<m>(uniformCubic(times[i])).value, 1e-12);
+    }
+
+    CHECK([&] {
+        try {
+            Table(std::vector<s>{1.0_s, 1.0_s}, std::vector<m>{1.0_m, 2.0_m});
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    }());
+}
+
+// The integrators against the analytic projectile and harmonic oscillator.
+void test_ode() {
+    using mps = decltype(m{} / s{});
+    using kmph = decltype(kilo<m>{} / hour{});
+    using mps2 = decltype(m{} / (s{} * s{}));
+    const double g = 9.81, omega = 2;
+    const size_t bodies = 3;
+    const auto gravity = [&](s, m, kmph, size_t) { return mps2{-g}; };
+    const auto spring = [&](s, m x, size_t) { return mps2{-omega * omega * x.value}; };
+
+    // Constant acceleration is integrated exactly by RK4 and Verlet, with velocities stored in km/h.
+    std::vector<m> height(bodies), verletHeight(bodies), eulerHeight(bodies);
+    std::vector<kmph> speed(bodies), verletSpeed(bodies), eulerSpeed(bodies);
+    std::vector<mps2> verletAcc(bodies);
+    for (size_t i = 0; i < bodies; ++i) speed[i] = kmph(mps(10.0 * (i + 1)));
+    verletSpeed = eulerSpeed = speed;
+    Unit::ode::accelerations(verletHeight, verletAcc, 0.0_s, [&](s, m, size_t) { return mps2{-g}; });
+    const double dt = 0.01;
+    for (int step = 0; step < 200; ++step) {
+        const s t(step * dt);
+        Unit::ode::rk4(height, speed, t, s(dt), gravity);
+        Unit::ode::verlet(verletHeight, verletSpeed, verletAcc, t, s(dt), [&](s, m, size_t) { return mps2{-g}; });
+        Unit::ode::semi_implicit_euler(eulerHeight, eulerSpeed, t, s(dt), gravity);
+    }
+    for (size_t i = 0; i < bodies; ++i) {
+        const double v0 = 10.0 * (i + 1), t = 2.0;
+        CHECK_NEAR(height[i].value, v0 * t - g * t * t / 2, 1e-9);
+        CHECK_NEAR(mps(speed[i]).value, v0 - g * t, 1e-9);
+        CHECK_NEAR(verletHeight[i].value, v0 * t - g * t * t / 2, 1e-9);
+        CHECK_NEAR(mps(verletSpeed[i]).value, v0 - g * t, 1e-9);
+        CHECK_NEAR(eulerHeight[i].value, v0 * t - g * t * t / 2, g * t * dt); // first order
+    }
+
+    // x'' = -omega^2 x from x = 1 m, v = 0 over one second: x = cos(omega t).
+    std::vector<m> x(bodies, 1.0_m), vx(bodies, 1.0_m);
+    std::vector<mps> v(bodies), vv(bodies);
+    std::vector<mps2> va(bodies);
+    Unit::ode::accelerations(vx, va, 0.0_s, spring);
+    for (int step = 0; step < 100; ++step) {
+        const s t(step * dt);
+        Unit::ode::rk4(x, v, t, s(dt), [&](s, m p, mps, size_t) { return mps2{-omega * omega * p.value}; });
+        Unit::ode::verlet(vx, vv, va, t, s(dt), spring);
+    }
+    CHECK_NEAR(x[0].value, std::cos(omega), 1e-8);
+    CHECK_NEAR(v[2].value, -omega * std::sin(omega), 1e-8);
+    CHECK_NEAR(vx[1].value, std::cos(omega), 5e-4); // second order
+    CHECK_NEAR(vv[1].value, -omega * std::sin(omega), 5e-4);
+
+    // y' = cos(t) m/s and y' = -y / s, with adaptive steps.
+    std::vector<m> ys(bodies, 0.0_m), decay(bodies, 2.0_m);
+    Unit::ode::AdaptiveOptions<m, s> options{1e-10_m, 1e-10, 0.1_s};
+    auto result = Unit::ode::dormand_prince(ys, 0.0_s, 3.0_s, [](s t, m, size_t) { return mps{std::cos(t.value)}; },
+                                            options);
+    CHECK(result.failed == 0 && result.steps > 0);
+    CHECK_NEAR(ys[1].value, std::sin(3.0), 1e-8);
+    result = Unit::ode::dormand_prince(decay, 0.0_s, 3.0_s, [](s, m y, size_t) { return mps{-y.value}; }, options);
+    CHECK(result.failed == 0);
+    CHECK_NEAR(decay[0].value, 2 * std::exp(-3.0), 1e-8);
+
+    std::vector<m> constant(bodies, 1.0_m);
+    Unit::ode::euler(constant, 0.0_s, 0.5_s, [](s, m, size_t) { return kmph{36}; });
+    CHECK_NEAR(constant[2].value, 6.0, 1e-12);
+}
+
+void test_dual() {
+    using D = Unit::Dual<double, 2>;
+    using mD = Unit::with_value_t<m, D>;
+    auto x = Unit::variable<2>(3.0_m, 0);
+    auto t = Unit::variable<2>(2.0_s, 1);
+
+    // Partial derivatives carry the units of y / x: d(x/t)/dt is m/s^2, d(x/t)/dx is 1/s.
+    auto v = x / t;
+    CHECK_NEAR(Unit::primal(v).value, 1.5, 1e-12);
+    CHECK_NEAR(Unit::derivative(v, x, 0).value, 0.5, 1e-12);
+    CHECK_NEAR(Unit::derivative(v, t, 1).value, -0.75, 1e-12);
+    CHECK_NEAR(Unit::derivative(x * x, x, 0).value, 6.0, 1e-12);
+
+    auto theta = Unit::variable<2>(0.5_rad, 0);
+    auto sine = Unit::defaults::sin(theta);
+    CHECK_NEAR(sine.x, std::sin(0.5), 1e-12);
+    CHECK_NEAR(sine.dx[0], std::cos(0.5), 1e-12);
+    CHECK_NEAR(sine.dx[1], 0.0, 1e-12);
+    CHECK_NEAR(Unit::math::sqrt(x * x).value.dx[0], 1.0, 1e-12);
+    CHECK_NEAR(Unit::defaults::atan2(x, mD(4.0)).value.dx[0], 4.0 / 25, 1e-12);
+    const D e = exp(D::variable(1.0, 0)), l = log(D::variable(2.0, 1)), p = pow(D::variable(3.0, 0), 2.0);
+    CHECK_NEAR(e.dx[0], std::exp(1.0), 1e-12);
+    CHECK_NEAR(l.dx[1], 0.5, 1e-12);
+    CHECK_NEAR(p.x, 9.0, 1e-12);
+    CHECK_NEAR(p.dx[0], 6.0, 1e-12);
+
+    auto length = Vector3<mD>(x, mD(4.0), mD(0.0)).length();
+    CHECK_NEAR(length.value.x, 5.0, 1e-12);
+    CHECK_NEAR(length.value.dx[0], 0.6, 1e-12);
+
+    // d(M w)/dM[0][0] = w[0] and d(M w)/dM[1][1] = w[1].
+    Matrix<2, 2, D> M(D::variable(2, 0), D(1), D(0), D::variable(3, 1));
+    auto r = M * Vector<2, D>(D(1), D(2));
+    CHECK_NEAR(r[0].x, 4.0, 1e-12);
+    CHECK_NEAR(r[0].dx[0], 1.0, 1e-12);
+    CHECK_NEAR(r[1].x, 6.0, 1e-12);
+    CHECK_NEAR(r[1].dx[1], 2.0, 1e-12);
+}
+
+void test_uncertain() {
+    const auto a = Unit::measured(10.0_m, 0.3_m), b = Unit::measured(4.0_m, centi<m>(40));
+    CHECK_NEAR(Unit::uncertainty(b).value, 0.4, 1e-12);
+    CHECK_NEAR(Unit::uncertainty(a + b).value, 0.5, 1e-12);
+    CHECK_NEAR(Unit::nominal(a * b).value, 40.0, 1e-12);
+    CHECK_NEAR(Unit::uncertainty(a * b).value, 40 * std::hypot(0.03, 0.1), 1e-12);
+    CHECK_NEAR((a / b).sigma(), 2.5 * std::hypot(0.03, 0.1), 1e-12); // dimensionless
+    CHECK_NEAR(Unit::uncertainty(a * 2.0).value, 0.6, 1e-12);
+    CHECK_NEAR(Unit::math::sqrt(a * a).value.sigma(), 0.3 / std::sqrt(2.0), 1e-12); // a * a as independent factors
+    const auto angle = Unit::measured(0.5_rad, 0.01_rad);
+    CHECK_NEAR(Unit::defaults::sin(angle).sigma(), 0.01 * std::cos(0.5), 1e-12);
+
+    // Uncorrelated operands are assumed independent even when they are the same value; correlated ones are not.
+    CHECK_NEAR(Unit::uncertainty(a - a).value, 0.3 * std::sqrt(2.0), 1e-12);
+    const auto c = Unit::measured<true>(10.0_m, 0.3_m), d = Unit::measured<true>(4.0_m, 0.4_m);
+    CHECK(Unit::uncertainty(c - c).value == 0);
+    CHECK_NEAR(Unit::uncertainty(c * c).value, 2 * 10 * 0.3, 1e-12);
+    CHECK_NEAR((c / c).sigma(), 0.0, 1e-12);
+    CHECK_NEAR(Unit::uncertainty(c + d).value, 0.5, 1e-12);
+    CHECK_NEAR(Unit::uncertainty((c + d) - d).value, 0.3, 1e-12);
+
+    Unit::UncertainList<std::remove_const_t<decltype(a)>> la, lb;
+    for (int i = 1; i <= 5; ++i) {
+        la.push_back(Unit::measured(m(i), 0.1_m * i));
+        lb.push_back(Unit::measured(m(2 * i), 0.2_m));
+    }
+    const auto sum = la + lb;
+    const auto product = la * lb;
+    CHECK(sum.size() == 5 && product.size() == 5);
+    for (size_t i = 0; i < 5; ++i) {
+        const auto scalarSum = la[i] + lb[i];
+        const auto scalarProduct = la[i] * lb[i];
+        CHECK_NEAR(Unit::nominal(sum[i]).value, Unit::nominal(scalarSum).value, 1e-12);
+        CHECK_NEAR(Unit::uncertainty(sum[i]).value, Unit::uncertainty(scalarSum).value, 1e-12);
+        CHECK_NEAR(Unit::nominal(product[i]).value, Unit::nominal(scalarProduct).value, 1e-12);
+        CHECK_NEAR(Unit::uncertainty(product[i]).value, Unit::uncertainty(scalarProduct).value, 1e-12);
+    }
+}
+
+void test_intervals() {
+    using I = Unit::Interval<double>;
+    const I sum = I(0.1) + I(0.2);
+    CHECK(sum.contains(0.1 + 0.2) && sum.lo < sum.hi && sum.width() < 1e-15);
+    const I product = I(-2, 3) * I(4, 5);
+    CHECK(product.lo <= -10 && product.lo > -10.001 && product.hi >= 15 && product.hi < 15.001);
+    const I quotient = I(1, 2) / I(-1, 1);
+    CHECK(std::isinf(quotient.lo) && std::isinf(quotient.hi));
+    const I root = sqrt(I(2));
+    CHECK(root.lo * root.lo <= 2 && root.hi * root.hi >= 2);
+    const I sine = sin(I(0.5, 0.6));
+    CHECK(sine.lo <= std::sin(0.5) && sine.hi >= std::sin(0.6));
+    const I peak = cos(I(-0.1, 0.1));
+    CHECK(peak.hi == 1 && peak.lo <= std::cos(0.1) && peak.lo > 0.99);
+
+    // Beyond 2^53 the multiples of pi cannot be told apart, so only the full range is certain.
+    for (const double x : {1e20, -1e300, 9007199254740992.0}) {
+        CHECK(cos(I(x)).lo == -1 && cos(I(x)).hi == 1);
+        CHECK(sin(I(x)).lo == -1 && sin(I(x)).hi == 1);
+    }
+    CHECK(cos(I(1e6, 1e6 + 5)).lo == -1 && cos(I(1e6, 1e6 + 5)).hi == 1);
+    const I far = cos(I(1e6));
+    CHECK(far.contains(std::cos(1e6)) && far.width() < 1e-9);
+
+    // Comparisons hold only for every pair of values within the bounds.
+    CHECK(I(1, 2) < I(3, 4));
+    CHECK(!(I(1, 3) < I(2, 4)) && !(I(1, 3) >= I(2, 4)));
+
+    // Integers beyond the mantissa are bracketed; smaller ones, signed or unsigned, stay exact.
+    using F = Unit::Interval<float>;
+    const F big(uint64_t{(1 << 24) + 1});
+    CHECK(big.lo < 16777217.0 && big.hi > 16777217.0);
+    const F negative(int64_t{-(1 << 24) - 1});
+    CHECK(negative.lo < -16777217.0 && negative.hi > -16777217.0);
+    CHECK(F(uint32_t{5}).lo == 5 && F(uint32_t{5}).hi == 5);
+    CHECK(F(uint64_t{1} << 20).width() == 0);
+    CHECK(F(int64_t{-5}).width() == 0);
+
+    // Spatial queries report rects that only may overlap the range.
+    Quadtree<I> tree(Rect<I>(I(0), I(0), I(128), I(128)), 4);
+    const auto id = tree.insert(Rect<I>(I(1), I(1), I(2), I(2)));
+    const Rect<I> maybe(I(2.9, 3.1), I(1), I(1), I(1)), never(I(3.1, 3.2), I(1), I(1), I(1));
+    CHECK(Rect<I>(I(1), I(1), I(2), I(2)).intersects(maybe) == Unit::Certainty::Maybe);
+    CHECK(tree.queryRange(maybe) == std::vector{id});
+    CHECK(tree.queryRange(never).empty());
+}
+
+void test_promotion() {
+    using mf = Unit::with_value_t<m, float>;
+    using mi = Unit::with_value_t<m, int>;
+    const auto scaled = px(3) * 1.5;
+    static_assert(std::is_same_v<decltype(scaled)::value_type, double>);
+    CHECK(scaled.value == 4.5);
+    static_assert(std::is_same_v<decltype(mf(2) * 1.5f)::value_type, float>);
+    static_assert(std::is_same_v<decltype(mf(3) * mf(2))::value_type, float>);
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(mf(3) / mf(2))>, float>); // dimensionless
+    CHECK(mf(3) / mf(2) == 1.5f);
+
+    const auto sum = mi(2) + 0.5_m;
+    const auto difference = 0.5_m - mi(2);
+    static_assert(std::is_same_v<decltype(sum)::value_type, double>);
+    static_assert(std::is_same_v<decltype(difference)::value_type, double>);
+    CHECK(sum.value == 2.5 && difference.value == -1.5);
+
+    // Matrix products follow the element types: units multiply and value types promote.
+    const Matrix<2, 2, m> a(1.0_m, 2.0_m, 3.0_m, 4.0_m);
+    const auto area = a * a;
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(area(0, 0))>, decltype(m{} * m{})>);
+    CHECK(area(0, 0).value == 7 && area(1, 1).value == 22);
+    const auto moment = a * Vector<2, m>(0.5_m, 0.25_m);
+    static_assert(std::is_same_v<std::remove_cvref_t<decltype(moment[0])>, decltype(m{} * m{})>);
+    CHECK(moment[0].value == 1.0 && moment[1].value == 2.5);
+    const auto wide = Matrix<1, 1, int16_t>(int16_t{300}) * Matrix<1, 1, int16_t>(int16_t{300});
+    CHECK(wide(0, 0) == 90000);
+
+    // Batch transforms write the same product types.
+    const std::vector<Vector<2, m>> sides{Vector<2, m>(1.0_m, 0.0_m), Vector<2, m>(0.5_m, 2.0_m)};
+    std::vector<Vector<2, decltype(m{} * m{})>> moments(sides.size());
+    a.transform(sides, moments);
+    CHECK(moments[0][1].value == 3 && moments[1][0].value == 4.5 && moments[1][1].value == 9.5);
+    const Matrix<2, 2, int8_t> small(int8_t{100}, int8_t{0}, int8_t{0}, int8_t{100});
+    const std::vector<Vector<2, int8_t>> in{Vector<2, int8_t>(int8_t{100}, int8_t{-100})};
+    std::vector<Vector<2, int>> out(1);
+    small.transform(in, out);
+    CHECK(out[0][0] == 10000 && out[0][1] == -10000);
+}
+
+void test_ratio_of() {
+    const auto half = Unit::ratio_of(px(3), px(2));
+    static_assert(std::is_same_v<decltype(half)::value_type, Unit::float_t>);
+    CHECK(half.value == 1.5 && static_cast<Unit::float_t>(half) == 1.5);
+
+    // The scale between the units stays in the type until the ratio is converted.
+    const auto r = Unit::ratio_of(kilo<m>(3.0), 2.0_m);
+    CHECK(r.value == 1.5);
+    CHECK(static_cast<double>(r) == 1500);
+    CHECK_NEAR(m{r * 2.0_m}.value, 3000.0, 1e-9);
+    using kmf = Unit::with_value_t<kilo<m>, float>;
+    static_assert(std::is_same_v<decltype(Unit::ratio_of(kmf(3), kmf(2)))::value_type, float>);
+
+    const auto angle = Unit::ratio_of(90.0_deg, Unit::pi * 1.0_rad);
+    CHECK(angle.value == 90 / Unit::pi);
+    CHECK_NEAR(static_cast<double>(angle), 0.5, 1e-12);
+}
+
+void test_scaled_view() {
+    using kmf = Unit::with_value_t<kilo<m>, float>;
+    using mf = Unit::with_value_t<m, float>;
+    using cmf = Unit::with_value_t<centi<m>, float>;
+    const kmf distance(1.234567f);
+
+    // km -> m -> cm -> m is read with the single km -> m factor, and returning to km touches nothing.
+    const auto chain = Unit::view(distance).to<mf>().to<cmf>().to<mf>();
+    static_assert(std::is_same_v<decltype(chain), const Unit::ScaledView<mf, kmf>>);
+    CHECK(chain.source().value == distance.value);
+    CHECK(chain.get().value == mf{distance}.value);
+    const mf implicit = chain;
+    CHECK(implicit.value == mf{distance}.value);
+    CHECK(chain.to<kmf>().get().value == distance.value);
+
+    // Explicit conversion to any other unit of the dimension converts from the source once.
+    CHECK(static_cast<cmf>(chain).value == cmf{distance}.value);
+    CHECK_NEAR(static_cast<Unit::with_value_t<milli<m>, double>>(chain).value, 1234567.0, 0.1);
+}
+
+void test_exact_scales() {
+    constexpr auto degToGrad = Unit::conversion_scale_v<deg::u, grad::u>;
+    static_assert(degToGrad.is_rational() && degToGrad.num == 10 && degToGrad.den == 9);
+    static_assert(std::is_same_v<Unit::conversion_ratio_t<deg::u, grad::u>, std::ratio<10, 9>>);
+    static_assert(std::is_same_v<Unit::conversion_ratio_t<deg::u, rad::u>, Unit::pi_ratio<std::ratio<1, 180>, 1>>);
+    CHECK(Unit::conversion_factor<double, deg::u, grad::u>() == 10.0 / 9.0);
+    CHECK(grad(90.0_deg).value == 100);
+    CHECK(deg(grad(90.0_deg)).value == 90);
+    CHECK(Unit::conversion_factor<double, deg::u, rad::u>() == Unit::pi / 180);
+
+    // 10^24 does not fit in intmax_t, so the scale continues in long double.
+    using m2 = decltype(m{} * m{});
+    using Tm2 = decltype(tera<m>{} * tera<m>{});
+    constexpr auto huge = Unit::conversion_scale_v<Tm2::u, m2::u>;
+    static_assert(!huge.exact);
+    CHECK(huge.approx == 1e24L);
+    CHECK_NEAR(m2(Tm2(2.0)).value / 2e24, 1.0, 1e-15);
+}
+
+void test_thread_pool() {
+    Unit::ThreadPool pool(4);
+    pool.setGrain(64);
+    const size_t n = 100000;
+
+    // Every index is visited exactly once, also with fewer threads or a coarser grain.
+    std::vector<std::atomic<int>> visits(n);
+    for (size_t threads : {0, 1, 2, 4, 9}) {
+        pool.parallelFor(n, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) visits[i].fetch_add(1, std::memory_order_relaxed);
+        }, threads, threads * 100);
+    }
+    CHECK(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& v) { return v.load() == 5; }));
+
+    // An exception is rethrown on the calling thread after the other chunks finished, and the pool stays usable.
+    std::atomic<size_t> done{0};
+    bool thrown = false;
+    try {
+        pool.parallelFor(n, [&](size_t begin, size_t end) {
+            if (begin <= n / 2 && n / 2 < end) throw std::runtime_error("chunk failed");
+            done.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown && done.load() < n && done.load() >= n / 2);
+
+    // Nested calls run serially inside the job.
+    std::atomic<size_t> inner{0};
+    pool.parallelFor(1000, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.parallelFor(n, [&](size_t b, size_t e) { inner.fetch_add(e - b, std::memory_order_relaxed); });
+        }
+    }, 0, 1);
+    CHECK(inner.load() == 1000 * n);
+
+    // The chunked sum does not depend on the thread count, including a single thread.
+    std::vector<float> values(3 * Unit::default_pool().grain() + 7);
+    std::mt19937 rng(46);
+    std::uniform_real_distribution<float> dist(0, 1000);
+    for (auto& v : values) v = dist(rng);
+    const auto term = [&](size_t i) { return static_cast<double>(values[i]); };
+    const double one = Unit::parallel_sum<double>(values.size(), 1, term).value();
+    CHECK(Unit::parallel_sum<double>(values.size(), 3, term).value() == one);
+    CHECK(Unit::parallel_sum<double>(values.size(), 0, term).value() == one);
+}
+
+// Inputs of a few grains, so that Unit::par splits them across the pool.
+void test_algorithms() {
+    using mps = decltype(m{} / s{});
+    const size_t n = 3 * Unit::default_pool().grain() + 77;
+    std::mt19937 rng(47);
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::vector<m> lengths(n);
+    for (auto& l : lengths) l = m(dist(rng) / 4.0);
+
+    std::vector<kilo<m>> seqOut(n), parOut(n);
+    const auto twice = [](m x) { return x * 2.0; };
+    Unit::transform(Unit::seq, lengths, seqOut, twice);
+    Unit::transform(Unit::par(4), lengths, parOut, twice);
+    CHECK(seqOut == parOut);
+    CHECK_NEAR(parOut[n - 1].value, lengths[n - 1].value / 500, 1e-15);
+    const auto areas = Unit::transform(Unit::par, lengths, [](m x) { return x * x; });
+    static_assert(std::is_same_v<decltype(areas)::value_type, decltype(m{} * m{})>);
+    CHECK(areas[5].value == lengths[5].value * lengths[5].value);
+
+    // Quarter metres sum exactly, so the chunked scan matches the serial one.
+    const auto seqScan = Unit::inclusive_scan(Unit::seq, lengths);
+    const auto parScan = Unit::inclusive_scan(Unit::par(4), lengths);
+    CHECK(seqScan == parScan);
+    double running = 0;
+    for (const auto& l : lengths) running += l.value;
+    CHECK(parScan.back().value == running);
+
+    // m/s * s increments scanned straight into positions in m.
+    std::vector<mps> velocities(n);
+    std::vector<s> dts(n, 0.5_s);
+    for (auto& v : velocities) v = mps(dist(rng));
+    std::vector<decltype(mps{} * s{})> steps(n);
+    Unit::transform(Unit::par(4), velocities, dts, steps, [](mps v, s dt) { return v * dt; });
+    std::vector<m> positions(n);
+    Unit::inclusive_scan(Unit::par(4), steps, positions);
+    running = 0;
+    for (size_t i = 0; i < n; ++i) running += velocities[i].value * 0.5;
+    CHECK(positions.back().value == running);
+    CHECK(positions[0].value == velocities[0].value * 0.5);
+
+    std::vector<m> seqSorted = lengths, parSorted = lengths;
+    Unit::sort(Unit::seq, seqSorted);
+    Unit::sort(Unit::par(4), parSorted);
+    CHECK(seqSorted == parSorted && std::is_sorted(parSorted.begin(), parSorted.end()));
+    Unit::sort(Unit::par(4), parSorted, std::greater<>{});
+    CHECK(std::is_sorted(parSorted.rbegin(), parSorted.rend()) && parSorted.front() == seqSorted.back());
+}
+
+void test_queues() {
+    Unit::SpscQueue<m> spsc(5);
+    CHECK(spsc.capacity() == 8);
+    std::vector<m> batch;
+    for (int i = 0; i < 10; ++i) batch.push_back(m(i * 1000.0));
+    CHECK(spsc.push(batch) == 8 && !spsc.push(1.0_m) && spsc.size() == 8);
+    m one;
+    CHECK(spsc.pop(one) && one.value == 0);
+    std::vector<kilo<m>> kms(4);
+    CHECK(spsc.pop(kms) == 4 && kms[0].value == 1 && kms[3].value == 4);
+
+    // Pushes and pops across the end of the slots keep the order.
+    CHECK(spsc.push(std::span<const m>(batch).subspan(8)) == 2);
+    std::vector<m> rest(8);
+    CHECK(spsc.pop(rest) == 5 && rest[2].value == 7000 && rest[4].value == 9000 && !spsc.pop(one));
+    int pushed = 0, popped = 0;
+    bool ordered = true;
+    for (int round = 0; round < 100; ++round) {
+        for (int k = 0; k < 3; ++k) spsc.push(m(pushed++));
+        for (int k = 0; k < 3; ++k) ordered = ordered && spsc.pop(one) && one.value == popped++;
+    }
+    CHECK(ordered && spsc.size() == 0);
+
+    Unit::MpscQueue<m> mpsc(4);
+    CHECK(mpsc.push(batch) == 4 && mpsc.size() == 4);
+    CHECK(mpsc.pop(kms) == 4 && kms[3].value == 3);
+    CHECK(mpsc.push(std::span<const m>(batch).subspan(4, 3)) == 3 && mpsc.pop(one) && one.value == 4000);
+
+    // One consumer thread against one producer, then against three.
+    const int count = 20000;
+    Unit::SpscQueue<m> stream(64);
+    std::thread producer([&] {
+        for (int i = 0; i < count;) {
+            if (stream.push(m(i))) ++i;
+            else std::this_thread::yield();
+        }
+    });
+    for (int next = 0; next < count;) {
+        if (!stream.pop(one)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && one.value == next++;
+    }
+    producer.join();
+    CHECK(ordered);
+
+    Unit::MpscQueue<m> shared(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 3; ++p) {
+        producers.emplace_back([&, p] {
+            std::vector<m> run(4);
+            for (int i = 0; i < count; i += 4) {
+                for (int k = 0; k < 4; ++k) run[k] = m(p * count + i + k);
+                for (size_t sent = 0; sent < run.size();) {
+                    const size_t n = shared.push(std::span<const m>(run).subspan(sent));
+                    if (n == 0) std::this_thread::yield();
+                    sent += n;
+                }
+            }
+        });
+    }
+    std::vector<int> next(3, 0);
+    std::vector<m> received(16);
+    for (int total = 0; total < 3 * count;) {
+        const size_t n = shared.pop(received);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) {
+            const int v = static_cast<int>(received[i].value), p = v / count;
+            ordered = ordered && v % count == next[p]++;
+        }
+        total += static_cast<int>(n);
+    }
+    for (auto& t : producers) t.join();
+    CHECK(ordered && next == std::vector<int>(3, count) && shared.size() == 0);
+}
+
+void test_atomics() {
+    Unit::atomic_quantity_t<J> energy(100.0_J);
+    CHECK(energy.fetch_add(kilo<J>(2)).value == 100 && energy.load().value == 2100);
+    CHECK(energy.fetch_sub(50.0_J).value == 2100);
+    CHECK((energy += kilo<J>(0.5)).value == 2550 && (energy -= 550.0_J).value == 2000);
+
+    // fetch_update applies any function, here a running maximum in another unit.
+    const auto previous = energy.fetch_update([](J e) { return std::max(e, J(kilo<J>(3))); });
+    CHECK(previous.value == 2000 && energy.load().value == 3000);
+    J expected = 1.0_J;
+    CHECK(!energy.compare_exchange_strong(expected, 0.0_J) && expected.value == 3000);
+    CHECK(energy.compare_exchange_strong(expected, 0.0_J) && J(energy).value == 0);
+
+    Unit::AtomicQuantity<J::u, int64_t> counted;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) counted.fetch_add(kilo<J>(1));
+        });
+    }
+    for (auto& t : threads) t.join();
+    CHECK(counted.load().value == 40000000);
+
+    Unit::ShardedQuantity<J::u, int64_t> sharded(3);
+    threads.clear();
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {
+                sharded += kilo<J>(1);
+                if (t == 0) sharded -= 500.0_J;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    CHECK(sharded.load().value == 35000000);
+    CHECK(sharded.reset().value == 35000000 && sharded.load().value == 0);
+    sharded.add(2.0_J);
+    const Unit::with_value_t<J, int64_t> total = sharded;
+    CHECK(total.value == 2);
+}
+
+void test_information_units() {
+    CHECK(bit(kilo<byte>(1)).value == 8000);
+    CHECK(bit(kibi<byte>(1)).value == 8192);
+    CHECK(byte(8.0_bit).value == 1);
+    CHECK_NEAR(Hz(kilo<Hz>(2)).value, 2000, 1e-9);
+    CHECK_NEAR(static_cast<double>(kilo<Hz>(1) * 2.0_ms), 2.0, 1e-12);
+    CHECK_NEAR(decltype(m{} * m{} * m{})(L(1500)).value, 1.5, 1e-12);
+    CHECK_NEAR(L(gal(1)).value, 3.785411784, 1e-12);
+
+    // Raising a unit with a scale of its own keeps the scale: a square mile is 1609.344^2 m^2.
+    using sqmi = Unit::compound_unit_q<mi, "sqmi", std::ratio<1>, 2>;
+    using m2 = decltype(m{} * m{});
+    CHECK_NEAR(m2(sqmi(1)).value, 1609.344 * 1609.344, 1e-6);
+    CHECK_NEAR(sqmi(mi(1) * mi(1)).value, 1.0, 1e-12);
+
+    Unit::RateMeter<> meter(1.0_s, 2);
+    const auto start = Unit::extra_functions::get_time_ns();
+    meter.record(kibi<byte>(2));
+    meter.record(48);
+    CHECK(meter.total().value == 2096);
+    // The first update averages over the time since construction, a little more than the second given here.
+    CHECK_NEAR(meter.update(start + decltype(start)(1e9)).value, 2096, 0.01);
+    CHECK_NEAR(meter.rate<Unit::with_value_t<kilo<Unit::defaults::bps>, double>>().value, 16.768, 1e-4);
+    meter.record(mebi<byte>(1));
+    const auto rate = meter.update(start + decltype(start)(2e9));
+    CHECK(rate.value > 2096 && rate.value < 1048576);
+}
+
+// In test_storage.cpp.
+void test_half();
+void test_storage_namespaces();
+
+void run_tests() {
+    print_header("TESTS");
+
+    test_rect_index(RectGrid<double>(6.0));
+    test_rect_index(Quadtree<double>(Rect<double>(0, 0, 128, 128), 4));
+    test_bvh();
+    test_rect_list();
+    test_exact_conversions();
+    test_half();
+    test_storage_namespaces();
+    test_roots_and_powers();
+    test_batch_trig();
+    test_inverse_trig();
+    test_reductions();
+    test_stats();
+    test_histograms();
+    test_lookup_tables();
+    test_ode();
+    test_dual();
+    test_uncertain();
+    test_intervals();
+    test_promotion();
+    test_ratio_of();
+    test_scaled_view();
+    test_exact_scales();
+    test_thread_pool();
+    test_algorithms();
+    test_queues();
+    test_atomics();
+    test_information_units();
+
+    std::cout << (failures == 0 ? "All checks passed.\n" : "Some checks failed.\n");
+}
+
 int main() {
+    // Several threads even on single-CPU machines, so the tests run the parallel paths.
+    Unit::default_pool_threads = 4;
+
     print_header("1. BASIC MOTION (Unit Inference)");
 
     std::cout << static_cast<double>(1_m) << " meters\n";
@@ -117,5 +1256,6 @@ int main() {
     std::cout << "Angle:      " << angle << "\n";
     std::cout << "Range:      " << range << "\n";
 
-    return 0;
+    run_tests();
+    return failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,68 @@
+// The float and Half storage namespaces are expensive to compile, so their tests live in a translation unit of
+// their own that is only rebuilt with the headers.
+#define UNIT_HPP_F32
+#define UNIT_HPP_F16
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "Reduce.hpp"
+#include "Unit.hpp"
+
+void check(bool ok, const char* expr, const char* file, int line);
+
+#define CHECK(...) check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+void test_half() {
+    using Unit::Half;
+
+    // Every non-NaN bit pattern survives a round trip through float.
+    for (uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        const Half h = Half::fromBits(static_cast<uint16_t>(bits));
+        const float f = h;
+        if (std::isnan(f)) CHECK(std::isnan(static_cast<float>(Half(f))));
+        else CHECK(Half(f).bits == bits);
+    }
+
+    // Round to nearest even, overflow to infinity, subnormals and underflow to zero.
+    CHECK(static_cast<float>(Half(1.0f + 0x1p-11f)) == 1.0f);
+    CHECK(static_cast<float>(Half(1.0f + 3 * 0x1p-11f)) == 1.0f + 0x1p-9f);
+    CHECK(static_cast<float>(Half(1.0f + 0x1p-11f + 0x1p-20f)) == 1.0f + 0x1p-10f);
+    CHECK(static_cast<float>(Half(65519.0f)) == 65504.0f);
+    CHECK(std::isinf(static_cast<float>(Half(65520.0f))));
+    CHECK(std::isinf(static_cast<float>(Half(-1e9f))) && static_cast<float>(Half(-1e9f)) < 0);
+    CHECK(Half(0x1p-24f).bits == 1 && Half(0x1p-25f + 0x1p-30f).bits == 1);
+    CHECK(Half(0x1p-25f).bits == 0 && Half(0x1p-26f).bits == 0 && Half(-0x1p-26f).bits == 0x8000);
+}
+
+void test_storage_namespaces() {
+    {
+        using namespace Unit::defaults::f32;
+        static_assert(std::is_same_v<decltype(1.5_m)::value_type, float>);
+        static_assert(std::is_same_v<decltype(2_km)::value_type, float>);
+        static_assert(std::is_same_v<decltype(1.5_m / 2.0_s)::value_type, float>);
+        CHECK(m(2_km).value == 2000.0f);
+
+        // Sums and means accumulate in double, which a float running sum of 0.1 would be far from.
+        std::vector<m> samples(1'000'000, 0.1_m);
+        auto total = Unit::sum(samples);
+        static_assert(std::is_same_v<decltype(total), Unit::Quantity<m::u, double>>);
+        CHECK(std::abs(total.value - 1e6 * static_cast<double>(0.1f)) < 1e-6);
+        CHECK(std::abs(Unit::mean(samples).value - static_cast<double>(0.1f)) < 1e-12);
+    }
+    {
+        using namespace Unit::defaults::f16;
+        static_assert(std::is_same_v<decltype(1.5_m)::value_type, Unit::Half>);
+        static_assert(std::is_same_v<decltype(2_km)::value_type, Unit::Half>);
+        CHECK(static_cast<float>(m(2_km).value) == 2000.0f);
+
+        std::vector<m> samples(100'000, 0.1_m);
+        const double tenth = static_cast<float>(Unit::Half(0.1f));
+        auto total = Unit::sum(samples);
+        static_assert(std::is_same_v<decltype(total), Unit::Quantity<m::u, double>>);
+        CHECK(std::abs(total.value - 1e5 * tenth) < 1e-6);
+        CHECK(std::abs(Unit::mean(samples).value - tenth) < 1e-12);
+    }
+}